@@ -0,0 +1,121 @@
+// bitboard.h - two-mask board representation for 3x3 Tic-Tac-Toe
+//
+// Bit i of each mask is cell i (0 = top-left, 8 = bottom-right).
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+
+#define BB_CELLS 9
+#define BB_FULL  0x1FF
+#define BB_STATES 19683   // 3^9 base-3 encodings
+
+typedef struct {
+    uint16_t x;   // cells held by X
+    uint16_t o;   // cells held by O
+} Bitboard;
+
+// Rows, columns, diagonals
+static const uint16_t BB_WIN_MASKS[8] = {
+    0x007, 0x038, 0x1C0,
+    0x049, 0x092, 0x124,
+    0x111, 0x054
+};
+
+static inline int bb_popcount(unsigned v)
+{
+    return __builtin_popcount(v);
+}
+
+// Lowest set cell of a non-zero mask
+static inline int bb_first(unsigned m)
+{
+    return __builtin_ctz(m);
+}
+
+// Check if a single player's mask contains a winning line
+static inline int bb_has_win(uint16_t m)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        if ((m & BB_WIN_MASKS[i]) == BB_WIN_MASKS[i])
+            return 1;
+    }
+    return 0;
+}
+
+static inline uint16_t bb_empty(Bitboard b)
+{
+    return (uint16_t)(~(b.x | b.o) & BB_FULL);
+}
+
+static inline int bb_empty_count(Bitboard b)
+{
+    return bb_popcount(bb_empty(b));
+}
+
+static inline int bb_is_full(Bitboard b)
+{
+    return (b.x | b.o) == BB_FULL;
+}
+
+// Accepts both cell alphabets in use: 'X'/'O' (GUI) and 'x'/'o' (datasets).
+// Anything else (' ', 'b', '0'..'8') is an empty cell.
+static inline Bitboard bb_from_chars(const char b[9])
+{
+    Bitboard bb = {0, 0};
+    for (int i = 0; i < BB_CELLS; i++)
+    {
+        if (b[i] == 'X' || b[i] == 'x')
+            bb.x |= (uint16_t)(1u << i);
+        else if (b[i] == 'O' || b[i] == 'o')
+            bb.o |= (uint16_t)(1u << i);
+    }
+    return bb;
+}
+
+// Write the board back out using the caller's alphabet
+static inline void bb_to_chars(Bitboard bb, char out[9], char cx, char co, char ce)
+{
+    for (int i = 0; i < BB_CELLS; i++)
+    {
+        if (bb.x & (1u << i))
+            out[i] = cx;
+        else if (bb.o & (1u << i))
+            out[i] = co;
+        else
+            out[i] = ce;
+    }
+}
+
+// Base-3 index: digit i is cell i (0 empty, 1 X, 2 O)
+static inline int bb_index(Bitboard bb)
+{
+    int idx = 0;
+    for (int i = BB_CELLS - 1; i >= 0; i--)
+    {
+        idx *= 3;
+        if (bb.x & (1u << i))
+            idx += 1;
+        else if (bb.o & (1u << i))
+            idx += 2;
+    }
+    return idx;
+}
+
+static inline Bitboard bb_from_index(int idx)
+{
+    Bitboard bb = {0, 0};
+    for (int i = 0; i < BB_CELLS; i++)
+    {
+        int d = idx % 3;
+        idx /= 3;
+        if (d == 1)
+            bb.x |= (uint16_t)(1u << i);
+        else if (d == 2)
+            bb.o |= (uint16_t)(1u << i);
+    }
+    return bb;
+}
+
+#endif // BITBOARD_H
@@ -2,7 +2,7 @@
 REM Compilation script for Tic-Tac-Toe with Modular AI System
 
 echo Compiling Tic-Tac-Toe GUI with Modular AI System...
-echo Including: Naive Bayes, Linear Regression, Q-Learning, Minimax
+echo Including: Naive Bayes, Linear Regression, Q-Learning, Minimax, MCTS
 echo.
 
 REM Adjust the raylib path if necessary
@@ -16,11 +16,13 @@ gcc -o ttt_gui.exe ^
     naive_bayes_ai.c ^
     linear_regression_ai.c ^
     q_learning_ai.c ^
+    mcts_ai.c ^
     model_config.c ^
     stats.c ^
     -I"C:\raylib\raylib\src" ^
     -L"C:\raylib\raylib\src" ^
     -lraylib -lopengl32 -lgdi32 -lwinmm -luser32 -lshell32 -lws2_32 -lpsapi ^
+    -pthread ^
     -Wall
 
 if %ERRORLEVEL% EQU 0 (
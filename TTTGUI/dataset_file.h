@@ -0,0 +1,219 @@
+// dataset_file.h - packed binary datasets (.tds)
+//
+// A 32-byte header, then every board as a little-endian uint16 base-3
+// index (bb_index), then every label packed 2 bits each, four to a
+// byte. A CSV line such as "x,o,b,x,x,o,b,b,x,win" (22 bytes) takes
+// 2.25 bytes, and ds_read() loads a whole file with one fread.
+//
+// Labels are DS_LABEL_* codes. Character datasets spell them win, lose
+// and draw; matrix datasets use +1, -1 and 0 for the same outcomes.
+#ifndef DATASET_FILE_H
+#define DATASET_FILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bitboard.h"
+
+#define DS_FILE_MAGIC    "TTDS"
+#define DS_FILE_VERSION  1
+#define DS_FILE_EXT      ".tds"
+
+#define DS_LABEL_WIN  0
+#define DS_LABEL_LOSE 1
+#define DS_LABEL_DRAW 2
+
+typedef struct
+{
+    char magic[4];           // DS_FILE_MAGIC
+    uint32_t version;        // DS_FILE_VERSION
+    uint32_t count;          // records
+    uint32_t checksum;       // ds_checksum() of the payload
+    uint32_t reserved[4];    // zero; pads the header to 32 bytes
+} DsFileHeader;
+
+// One record, unpacked
+typedef struct
+{
+    uint16_t board;          // bb_index() of the board
+    uint8_t label;           // DS_LABEL_*
+} DsRecord;
+
+// Boards, then labels at 2 bits each
+static inline size_t ds_payload_size(uint32_t count)
+{
+    return (size_t)count * 2 + ((size_t)count + 3) / 4;
+}
+
+// FNV-1a over bytes
+static inline uint32_t ds_checksum(const unsigned char *data, size_t size)
+{
+    uint32_t h = 2166136261u;
+
+    for (size_t i = 0; i < size; i++)
+        h = (h ^ data[i]) * 16777619u;
+    return h;
+}
+
+// Does the name end in DS_FILE_EXT?
+static inline int ds_is_binary_name(const char *path)
+{
+    size_t n = strlen(path), e = strlen(DS_FILE_EXT);
+    return n >= e && strcmp(path + n - e, DS_FILE_EXT) == 0;
+}
+
+// Does the file start with DS_FILE_MAGIC?
+static inline int ds_is_binary_file(const char *path)
+{
+    char magic[4];
+    FILE *fp = fopen(path, "rb");
+    int ok;
+
+    if (!fp)
+        return 0;
+    ok = fread(magic, 1, 4, fp) == 4 && memcmp(magic, DS_FILE_MAGIC, 4) == 0;
+    fclose(fp);
+    return ok;
+}
+
+// DS_LABEL_* for "win", "lose" or "draw"; -1 for anything else
+static inline int ds_label_code(const char *name)
+{
+    if (strcmp(name, "win") == 0)
+        return DS_LABEL_WIN;
+    if (strcmp(name, "lose") == 0)
+        return DS_LABEL_LOSE;
+    if (strcmp(name, "draw") == 0)
+        return DS_LABEL_DRAW;
+    return -1;
+}
+
+static inline const char *ds_label_name(int label)
+{
+    return label == DS_LABEL_WIN ? "win" : label == DS_LABEL_LOSE ? "lose" : "draw";
+}
+
+// Matrix-format outcome: +1 win, -1 lose, 0 draw
+static inline int ds_label_value(int label)
+{
+    return label == DS_LABEL_WIN ? 1 : label == DS_LABEL_LOSE ? -1 : 0;
+}
+
+static inline int ds_label_from_value(int value)
+{
+    return value > 0 ? DS_LABEL_WIN : value < 0 ? DS_LABEL_LOSE : DS_LABEL_DRAW;
+}
+
+// Board as 'x' / 'o' / 'b' characters (dataset alphabet)
+static inline void ds_record_cells(const DsRecord *r, char cells[BB_CELLS])
+{
+    bb_to_chars(bb_from_index(r->board), cells, 'x', 'o', 'b');
+}
+
+// Board as matrix features: x = 1.0, o = -1.0, b = 0.0
+static inline void ds_record_features(const DsRecord *r, double features[BB_CELLS])
+{
+    Bitboard bb = bb_from_index(r->board);
+
+    for (int i = 0; i < BB_CELLS; i++)
+        features[i] = (bb.x >> i) & 1 ? 1.0 : (bb.o >> i) & 1 ? -1.0 : 0.0;
+}
+
+static inline DsRecord ds_record_from_cells(const char cells[BB_CELLS], int label)
+{
+    DsRecord r;
+    r.board = (uint16_t)bb_index(bb_from_chars(cells));
+    r.label = (uint8_t)label;
+    return r;
+}
+
+// Returns 1 on success
+static inline int ds_write(const char *path, const DsRecord *records, int count)
+{
+    DsFileHeader h;
+    size_t size = ds_payload_size((uint32_t)count);
+    unsigned char *payload = (unsigned char *)calloc(size ? size : 1, 1);
+    unsigned char *labels = payload + (size_t)count * 2;
+    FILE *fp;
+    int ok;
+
+    if (!payload)
+        return 0;
+    for (int i = 0; i < count; i++)
+    {
+        payload[2 * i] = (unsigned char)(records[i].board & 0xFF);
+        payload[2 * i + 1] = (unsigned char)(records[i].board >> 8);
+        labels[i / 4] |= (unsigned char)((records[i].label & 3) << (2 * (i % 4)));
+    }
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, DS_FILE_MAGIC, 4);
+    h.version = DS_FILE_VERSION;
+    h.count = (uint32_t)count;
+    h.checksum = ds_checksum(payload, size);
+
+    fp = fopen(path, "wb");
+    ok = fp && fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(payload, 1, size, fp) == size;
+    if (fp && fclose(fp) != 0)
+        ok = 0;
+    free(payload);
+    return ok;
+}
+
+// Whole file in one read. Returns a malloc'd array of *count records
+// (free() it), or NULL after printing the reason.
+static inline DsRecord *ds_read(const char *path, int *count)
+{
+    DsFileHeader h;
+    FILE *fp = fopen(path, "rb");
+    const char *err = NULL;
+    unsigned char *payload = NULL;
+    DsRecord *records = NULL;
+    size_t size = 0;
+
+    *count = 0;
+    if (!fp)
+        err = "cannot open file";
+    else if (fread(&h, sizeof(h), 1, fp) != 1 || memcmp(h.magic, DS_FILE_MAGIC, 4) != 0)
+        err = "not a packed dataset";
+    else if (h.version != DS_FILE_VERSION)
+        err = "unsupported version";
+    else
+    {
+        size = ds_payload_size(h.count);
+        payload = (unsigned char *)malloc(size + 1);
+        records = (DsRecord *)malloc(sizeof(DsRecord) * (h.count ? h.count : 1));
+        if (!payload || !records)
+            err = "out of memory";
+        else if (fread(payload, 1, size + 1, fp) != size)
+            err = "wrong file size";
+        else if (ds_checksum(payload, size) != h.checksum)
+            err = "checksum mismatch";
+    }
+    if (fp)
+        fclose(fp);
+
+    if (!err)
+    {
+        const unsigned char *labels = payload + (size_t)h.count * 2;
+        for (uint32_t i = 0; i < h.count && !err; i++)
+        {
+            records[i].board = (uint16_t)(payload[2 * i] | (payload[2 * i + 1] << 8));
+            records[i].label = (labels[i / 4] >> (2 * (i % 4))) & 3;
+            if (records[i].board >= BB_STATES || records[i].label > DS_LABEL_DRAW)
+                err = "bad record";
+        }
+    }
+    free(payload);
+
+    if (err)
+    {
+        fprintf(stderr, "Error: %s: %s\n", path, err);
+        free(records);
+        return NULL;
+    }
+    *count = (int)h.count;
+    return records;
+}
+
+#endif // DATASET_FILE_H
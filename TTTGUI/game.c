@@ -1,24 +1,115 @@
 #include "game.h"
 #include "minimax.h"
+#include "bitboard.h"
 #include "naive_bayes_ai.h"
 #include "linear_regression_ai.h"
 #include "q_learning_ai.h"
+#include "mcts_ai.h"
 #include "model_config.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
 
 // AI model structures
 static NaiveBayesModel nb_model;
 static LinearRegressionModel lr_model;
-static QLearningModel ql_model;
+static MCTSModel mcts_model;
 
 // Flags for loaded status
 static int nb_model_loaded = 0;
 static int lr_model_loaded = 0;
-static int ql_model_loaded = 0;
+static int mcts_model_ready = 0;
 
 // Current AI settings
 static AIConfig current_config;
 
+// Q-Learning model in use. Reloads build a fresh model on a worker
+// thread and swap it in here; the old one is freed once no move
+// computation is reading it (ql_readers back to 0).
+static QLearningModel *ql_active = NULL;
+static int ql_readers = 0;
+static int ql_reload_busy = 0;
+
+// Load path into a new heap model; NULL on failure
+static QLearningModel *ql_load_fresh(const char *path)
+{
+    QLearningModel *m = malloc(sizeof(*m));
+
+    if (!m)
+        return NULL;
+    if (!ql_load_model(path, m))
+    {
+        ql_free_model(m);
+        free(m);
+        return NULL;
+    }
+    return m;
+}
+
+// Make m the active model and retire the one it replaces
+static void ql_publish(QLearningModel *m)
+{
+    QLearningModel *old = __atomic_exchange_n(&ql_active, m, __ATOMIC_SEQ_CST);
+
+    if (!old)
+        return;
+
+    // Readers that started before the swap may still hold old
+    while (__atomic_load_n(&ql_readers, __ATOMIC_SEQ_CST) != 0)
+        sched_yield();
+    ql_free_model(old);
+    free(old);
+}
+
+static void *ql_reload_worker(void *arg)
+{
+    char *path = arg;
+    QLearningModel *m = ql_load_fresh(path);
+
+    if (m)
+    {
+        ql_publish(m);
+        printf("Reloaded Q-Learning: %s\n", path);
+    }
+    else
+        printf("Failed: %s (keeping current Q-Learning model)\n", path);
+
+    free(path);
+    __atomic_store_n(&ql_reload_busy, 0, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Start a background reload; returns 0 if one could not be started
+static int ql_reload_async(const char *path)
+{
+    pthread_t thread;
+    char *copy;
+
+    if (__atomic_exchange_n(&ql_reload_busy, 1, __ATOMIC_ACQUIRE))
+    {
+        printf("Q-Learning reload already in progress, ignoring %s\n", path);
+        return 0;
+    }
+
+    copy = malloc(strlen(path) + 1);
+    if (copy)
+    {
+        strcpy(copy, path);
+        if (pthread_create(&thread, NULL, ql_reload_worker, copy) == 0)
+        {
+            pthread_detach(thread);
+            return 1;
+        }
+        free(copy);
+    }
+
+    __atomic_store_n(&ql_reload_busy, 0, __ATOMIC_RELEASE);
+    printf("Failed to start Q-Learning reload: %s\n", path);
+    return 0;
+}
+
 void game_init(Game *g)
 {
     // Clear board
@@ -40,13 +131,8 @@ void game_reset(Game *g)
 
 int game_is_full(const Game *g)
 {
-    // Check for empty cells
-    for (int i = 0; i < 9; i++)
-        if (g->b[i] != 'X' && g->b[i] != 'O')
-            return 0;
-
-    // Board full
-    return 1;
+    // Full when no empty cells remain
+    return bb_is_full(bb_from_chars(g->b));
 }
 
 int game_make_move(Game *g, int index)
@@ -73,16 +159,19 @@ int game_make_move(Game *g, int index)
 
 void game_check_end(Game *g)
 {
+    // Convert once, then test masks
+    Bitboard bb = bb_from_chars(g->b);
+
     // Check X win
-    if (winBy(g->b, 'X'))
+    if (bb_has_win(bb.x))
         g->winner = 1;
 
     // Check O win
-    else if (winBy(g->b, 'O'))
+    else if (bb_has_win(bb.o))
         g->winner = 2;
 
     // Check draw
-    else if (game_is_full(g))
+    else if (bb_is_full(bb))
         g->winner = 3;
 
     // Game continues
@@ -95,6 +184,9 @@ void game_load_all_models(void)
     // Load best-config preset
     ai_config_preset_best_models(&current_config);
 
+    // Solve perfect-play table for Hard minimax
+    minimax_init();
+
     // Load Naive Bayes
     if (!nb_model_loaded)
     {
@@ -120,17 +212,34 @@ void game_load_all_models(void)
     }
 
     // Load Q-Learning
-    if (!ql_model_loaded)
+    if (!__atomic_load_n(&ql_active, __ATOMIC_SEQ_CST))
     {
-        if (ql_load_model("../models/q learning/q_learning_dataset.txt", &ql_model))
+        // Binary model (memory-mapped) if one was converted, else the text one
+        FILE *bin = fopen("../models/q learning/q_learning_dataset.qtb", "rb");
+        const char *ql_path = bin ? "../models/q learning/q_learning_dataset.qtb"
+                                  : "../models/q learning/q_learning_dataset.txt";
+        if (bin)
+            fclose(bin);
+
+        QLearningModel *m = ql_load_fresh(ql_path);
+        if (m)
         {
-            ql_model_loaded = 1;
+            ql_publish(m);
             printf("Q-Learning model loaded\n");
         }
         else
             printf("Failed to load Q-Learning model\n");
     }
 
+    // Set up MCTS node arena
+    if (!mcts_model_ready)
+    {
+        if (mcts_init(&mcts_model, MCTS_DEFAULT_NODES, MCTS_DEFAULT_PLAYOUTS, 0.0))
+            mcts_model_ready = 1;
+        else
+            printf("Failed to allocate MCTS tree\n");
+    }
+
     // Print config
     printf("\nCurrent AI Configuration:\n");
     printf("  Easy:   %s\n", ai_config_get_model_name(current_config.easy_model));
@@ -183,16 +292,14 @@ void game_load_model_file(AIModelType model_type, const char *path)
             break;
 
         case AI_MODEL_Q_LEARNING:
-            if (ql_model_loaded)
-                ql_free_model(&ql_model);
+            // Parsed off the render thread; the current model keeps
+            // playing until the new one is ready
+            if (ql_reload_async(path))
+                printf("Reloading Q-Learning in background: %s\n", path);
+            break;
 
-            if (ql_load_model(path, &ql_model))
-            {
-                ql_model_loaded = 1;
-                printf("Reloaded Q-Learning: %s\n", path);
-            }
-            else
-                printf("Failed: %s\n", path);
+        case AI_MODEL_MCTS:
+            printf("Cannot reload MCTS (search-based)\n");
             break;
 
         default:
@@ -201,6 +308,13 @@ void game_load_model_file(AIModelType model_type, const char *path)
     }
 }
 
+void game_set_mcts_budget(int playouts, double time_ms)
+{
+    // More playouts (or time) = stronger but slower moves
+    if (mcts_model_ready)
+        mcts_set_budget(&mcts_model, playouts, time_ms);
+}
+
 const char* game_get_ai_name(int level)
 {
     // Get model name
@@ -233,9 +347,16 @@ void game_ai_move(Game *g, int level)
             break;
 
         case AI_MODEL_Q_LEARNING:
-            if (ql_model_loaded)
-                mv = ql_find_best_move(&ql_model, g->b);
+        {
+            // Count as a reader before taking the pointer, so a reload
+            // cannot free it under us
+            __atomic_fetch_add(&ql_readers, 1, __ATOMIC_SEQ_CST);
+            QLearningModel *m = __atomic_load_n(&ql_active, __ATOMIC_SEQ_CST);
+            if (m)
+                mv = ql_find_best_move(m, g->b);
+            __atomic_fetch_sub(&ql_readers, 1, __ATOMIC_RELEASE);
             break;
+        }
 
         case AI_MODEL_MINIMAX_EASY:
             mv = findBestMoveLvl(g->b, 2);
@@ -245,6 +366,11 @@ void game_ai_move(Game *g, int level)
             mv = findBestMoveLvl(g->b, 3);
             break;
 
+        case AI_MODEL_MCTS:
+            if (mcts_model_ready)
+                mv = mcts_find_best_move(&mcts_model, g->b);
+            break;
+
         default:
             mv = findBestMoveLvl(g->b, 3);
             break;
@@ -35,9 +35,13 @@ void game_set_ai_config(const AIConfig *config);
 // Get AI config
 void game_get_ai_config(AIConfig *config);
 
-// Reload specific AI model
+// Reload specific AI model. Q-Learning models load on a background
+// thread and replace the current one only if the load succeeds.
 void game_load_model_file(AIModelType model_type, const char *path);
 
+// MCTS budget per move: playouts, or time in ms when time_ms > 0
+void game_set_mcts_budget(int playouts, double time_ms);
+
 // AI plays move for O
 void game_ai_move(Game *g, int level);
 
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include "game.h"
 #include "stats.h"
+#include "minimax.h"
 
 //Define pop up window sizr and size of tic tac toe grid
 #define W_WIDTH 620
@@ -180,12 +181,18 @@ int main(void)
         // AI logic flow
         if (mode == 1 && g.winner == 0 && g.turn == 'O')
         {
+            unsigned long nodes0, cuts0, nodes1, cuts1;
+            minimax_get_stats(&nodes0, &cuts0);
+
             double t0 = GetTime();
             game_ai_move(&g, level);
             double ms = (GetTime() - t0) * 1000.0;
+
+            minimax_get_stats(&nodes1, &cuts1);
             
             int depth_used = (level == 1 ? 1 : (level == 2 ? 3 : 0));
-            stats_log_ai_move(mode, level, ai_move_no, ms, depth_used);
+            stats_log_ai_move(mode, level, ai_move_no, ms, depth_used,
+                              nodes1 - nodes0, cuts1 - cuts0);
             game_check_end(&g);
         }
 
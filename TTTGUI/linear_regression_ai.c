@@ -1,4 +1,5 @@
 #include "linear_regression_ai.h"
+#include "bitboard.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,13 +37,13 @@ int lr_load_model(const char *filename, LinearRegressionModel *model) {
     return 1;
 }
 
-static void encode_features(const char *board, double *features) {
+static void encode_features(Bitboard bb, double *features) {
     features[0] = 1.0;
     
     for (int i = 0; i < 9; i++) {
-        if (board[i] == 'X') {
+        if (bb.x & (1u << i)) {
             features[i + 1] = 1.0;
-        } else if (board[i] == 'O') {
+        } else if (bb.o & (1u << i)) {
             features[i + 1] = -1.0;
         } else {
             features[i + 1] = 0.0;
@@ -59,30 +60,23 @@ static double lr_predict(const LinearRegressionModel *model, const double *featu
 }
 
 int lr_find_best_move(const LinearRegressionModel *model, char board[9]) {
-    int empty_cells[9];
-    int empty_count = 0;
+    Bitboard bb = bb_from_chars(board);
+    unsigned empty = bb_empty(bb);
     
-    for (int i = 0; i < 9; i++) {
-        if (board[i] != 'X' && board[i] != 'O') {
-            empty_cells[empty_count++] = i;
-        }
-    }
-    
-    if (empty_count == 0) {
+    if (empty == 0) {
         return -1;
     }
-    int best_move = empty_cells[0];
+    int best_move = bb_first(empty);
     double best_score = -1000.0;
     
-    for (int i = 0; i < empty_count; i++) {
-        int move = empty_cells[i];
+    for (unsigned m = empty; m; m &= m - 1) {
+        int move = bb_first(m);
         
-        char temp_board[9];
-        memcpy(temp_board, board, 9);
-        temp_board[move] = 'O';
+        Bitboard temp = bb;
+        temp.o |= (uint16_t)(1u << move);
         
         double features[NUM_FEATURES];
-        encode_features(temp_board, features);
+        encode_features(temp, features);
         double score = lr_predict(model, features);
         
         if (score > best_score) {
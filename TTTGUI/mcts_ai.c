@@ -0,0 +1,305 @@
+#include "mcts_ai.h"
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+static unsigned mcts_rand(MCTSModel *model) {
+    // xorshift32
+    unsigned x = model->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    model->rng = x;
+    return x;
+}
+
+// Random set bit of a non-zero mask
+static int random_cell(MCTSModel *model, unsigned mask) {
+    int skip = (int)(mcts_rand(model) % (unsigned)bb_popcount(mask));
+    while (skip-- > 0) {
+        mask &= mask - 1;
+    }
+    return bb_first(mask);
+}
+
+// 0 ongoing, 1 X won, 2 O won, 3 draw
+static uint8_t board_result(Bitboard bb) {
+    if (bb_has_win(bb.x)) return 1;
+    if (bb_has_win(bb.o)) return 2;
+    if (bb_is_full(bb)) return 3;
+    return 0;
+}
+
+// Monotonic wall clock in ms (clock() is CPU time on POSIX)
+static double wall_ms(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+static int new_node(MCTSModel *model, Bitboard bb, int parent, int move, int mover) {
+    if (model->used >= model->capacity) {
+        return -1;
+    }
+
+    int idx = model->used++;
+    MCTSNode *n = &model->pool[idx];
+
+    n->board = bb;
+    n->parent = parent;
+    n->first_child = -1;
+    n->next_sibling = -1;
+    n->move = (int8_t)move;
+    n->mover = (uint8_t)mover;
+    n->result = board_result(bb);
+    n->untried = n->result ? 0 : bb_empty(bb);
+    n->visits = 0;
+    n->reward = 0.0f;
+
+    if (parent >= 0) {
+        n->next_sibling = model->pool[parent].first_child;
+        model->pool[parent].first_child = idx;
+    }
+    return idx;
+}
+
+int mcts_init(MCTSModel *model, int capacity, int playouts, double time_ms) {
+    model->pool = (MCTSNode *)malloc((size_t)capacity * sizeof(MCTSNode));
+    model->scratch = (MCTSNode *)malloc((size_t)capacity * sizeof(MCTSNode));
+    if (!model->pool || !model->scratch) {
+        free(model->pool);
+        free(model->scratch);
+        model->pool = model->scratch = NULL;
+        return 0;
+    }
+
+    model->capacity = capacity;
+    model->used = 0;
+    model->root = -1;
+    model->rng = (unsigned)time(NULL) | 1u;
+    model->last_playouts = 0;
+    model->last_reused = 0;
+    mcts_set_budget(model, playouts, time_ms);
+    return 1;
+}
+
+void mcts_set_budget(MCTSModel *model, int playouts, double time_ms) {
+    model->playouts = playouts > 0 ? playouts : MCTS_DEFAULT_PLAYOUTS;
+    model->time_ms = time_ms > 0.0 ? time_ms : 0.0;
+}
+
+void mcts_reset(MCTSModel *model) {
+    model->used = 0;
+    model->root = -1;
+}
+
+void mcts_free(MCTSModel *model) {
+    free(model->pool);
+    free(model->scratch);
+    model->pool = model->scratch = NULL;
+    model->used = 0;
+    model->root = -1;
+}
+
+// Copy the subtree under new_root into the scratch arena (breadth first,
+// so it becomes node 0) and swap arenas. Everything else is dropped.
+static void reroot(MCTSModel *model, int new_root) {
+    MCTSNode *src = model->pool;
+    MCTSNode *dst = model->scratch;
+    int n = 1;
+
+    dst[0] = src[new_root];
+    dst[0].parent = -1;
+    dst[0].next_sibling = -1;
+
+    for (int i = 0; i < n; i++) {
+        int old_child = dst[i].first_child;   // still an index into src
+        int prev = -1;
+
+        dst[i].first_child = -1;
+        while (old_child != -1) {
+            dst[n] = src[old_child];
+            dst[n].parent = i;
+            dst[n].next_sibling = -1;
+            if (prev == -1) {
+                dst[i].first_child = n;
+            } else {
+                dst[prev].next_sibling = n;
+            }
+            prev = n++;
+            old_child = src[old_child].next_sibling;
+        }
+    }
+
+    model->pool = dst;
+    model->scratch = src;
+    model->used = n;
+    model->root = 0;
+}
+
+// Look for bb among the root's children and grandchildren (our last
+// move and the opponent's reply); re-root there or start a new tree
+static void attach_root(MCTSModel *model, Bitboard bb) {
+    int found = -1;
+
+    if (model->root >= 0) {
+        MCTSNode *pool = model->pool;
+        int root = model->root;
+
+        if (pool[root].board.x == bb.x && pool[root].board.o == bb.o) {
+            found = root;
+        }
+        for (int c = pool[root].first_child; c != -1 && found < 0; c = pool[c].next_sibling) {
+            if (pool[c].board.x == bb.x && pool[c].board.o == bb.o) {
+                found = c;
+                break;
+            }
+            for (int g = pool[c].first_child; g != -1; g = pool[g].next_sibling) {
+                if (pool[g].board.x == bb.x && pool[g].board.o == bb.o) {
+                    found = g;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (found >= 0) {
+        if (found != model->root) {
+            reroot(model, found);
+        }
+        model->last_reused = model->used;
+        return;
+    }
+
+    // New game or unrelated position: side that moved last is the root's mover
+    mcts_reset(model);
+    int x_to_move = bb_popcount(bb.x) == bb_popcount(bb.o);
+    model->root = new_node(model, bb, -1, -1, x_to_move ? 1 : 0);
+    model->last_reused = 0;
+}
+
+static int uct_select(const MCTSModel *model, int node) {
+    const MCTSNode *pool = model->pool;
+    double log_n = log((double)pool[node].visits);
+    double best_score = -1.0;
+    int best = -1;
+
+    for (int c = pool[node].first_child; c != -1; c = pool[c].next_sibling) {
+        double score = pool[c].reward / pool[c].visits +
+                       MCTS_EXPLORATION * sqrt(log_n / pool[c].visits);
+        if (score > best_score) {
+            best_score = score;
+            best = c;
+        }
+    }
+    return best;
+}
+
+// Random game to the end; returns 1 X won, 2 O won, 3 draw
+static int rollout(MCTSModel *model, Bitboard bb, int to_move) {
+    for (;;) {
+        int cell = random_cell(model, bb_empty(bb));
+        uint16_t bit = (uint16_t)(1u << cell);
+
+        if (to_move == 0) {
+            bb.x |= bit;
+            if (bb_has_win(bb.x)) return 1;
+        } else {
+            bb.o |= bit;
+            if (bb_has_win(bb.o)) return 2;
+        }
+        if (bb_is_full(bb)) return 3;
+        to_move ^= 1;
+    }
+}
+
+// One select / expand / simulate / backpropagate pass. With the arena
+// full, the tree stops growing and playouts run from its leaves.
+static void run_playout(MCTSModel *model) {
+    MCTSNode *pool = model->pool;
+    int node = model->root;
+
+    // Select: descend through fully expanded nodes
+    while (pool[node].result == 0 && pool[node].untried == 0) {
+        node = uct_select(model, node);
+    }
+
+    // Expand one untried move
+    if (pool[node].result == 0) {
+        int cell = random_cell(model, pool[node].untried);
+        int mover = pool[node].mover ^ 1;
+        Bitboard child = pool[node].board;
+
+        if (mover == 0) {
+            child.x |= (uint16_t)(1u << cell);
+        } else {
+            child.o |= (uint16_t)(1u << cell);
+        }
+
+        int idx = new_node(model, child, node, cell, mover);
+        if (idx >= 0) {
+            pool[node].untried &= (uint16_t)~(1u << cell);
+            node = idx;
+        }
+    }
+
+    // Simulate
+    int result = pool[node].result ? pool[node].result
+                                   : rollout(model, pool[node].board, pool[node].mover ^ 1);
+
+    // Backpropagate, scoring each node for the side that moved into it
+    for (; node != -1; node = pool[node].parent) {
+        pool[node].visits++;
+        if (result == 3) {
+            pool[node].reward += 0.5f;
+        } else if (result - 1 == pool[node].mover) {
+            pool[node].reward += 1.0f;
+        }
+    }
+}
+
+int mcts_find_best_move(MCTSModel *model, char board[9]) {
+    Bitboard bb = bb_from_chars(board);
+
+    model->last_playouts = 0;
+    if (!model->pool || board_result(bb) != 0) {
+        return -1;
+    }
+
+    attach_root(model, bb);
+
+    // Playout or time budget, checked after each playout so the root
+    // always gets at least one (a tiny budget still returns a move)
+    double start = wall_ms();
+
+    for (;;) {
+        run_playout(model);
+        model->last_playouts++;
+        if (model->time_ms > 0.0) {
+            if ((model->last_playouts & 31) == 0 && wall_ms() - start >= model->time_ms) break;
+        } else if (model->last_playouts >= model->playouts) {
+            break;
+        }
+    }
+
+    // Most visited child is the most robust choice
+    int best = -1, best_visits = -1;
+    for (int c = model->pool[model->root].first_child; c != -1; c = model->pool[c].next_sibling) {
+        if (model->pool[c].visits > best_visits) {
+            best_visits = model->pool[c].visits;
+            best = model->pool[c].move;
+        }
+    }
+    return best;
+}
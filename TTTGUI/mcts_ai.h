@@ -0,0 +1,54 @@
+#ifndef MCTS_AI_H
+#define MCTS_AI_H
+
+#include "bitboard.h"
+
+#define MCTS_DEFAULT_NODES     65536   // arena size (nodes)
+#define MCTS_DEFAULT_PLAYOUTS  5000    // per move
+#define MCTS_EXPLORATION       1.41421356   // UCT constant, sqrt(2)
+
+// One tree node. Nodes live in a fixed arena and link by index.
+typedef struct {
+    Bitboard board;        // position after `move`
+    int parent;            // -1 for the root
+    int first_child;       // -1 until expanded
+    int next_sibling;
+    uint16_t untried;      // empty cells not expanded yet
+    int8_t move;           // cell played to reach this node (-1 at root)
+    uint8_t mover;         // side that played `move`: 0 = X, 1 = O
+    uint8_t result;        // 0 ongoing, 1 X won, 2 O won, 3 draw
+    int visits;
+    float reward;          // total reward for `mover` (win 1, draw 0.5)
+} MCTSNode;
+
+typedef struct {
+    MCTSNode *pool;        // arena in use
+    MCTSNode *scratch;     // second arena, used when re-rooting
+    int capacity;
+    int used;
+    int root;              // -1 when there is no tree
+    int playouts;          // budget per move (used when time_ms is 0)
+    double time_ms;        // time budget per move, 0 = playout budget
+    unsigned rng;
+
+    // Last search, for tuning the budget
+    int last_playouts;
+    int last_reused;       // nodes kept from the previous move's tree
+} MCTSModel;
+
+// Allocate the arena; returns 0 if out of memory
+int mcts_init(MCTSModel *model, int capacity, int playouts, double time_ms);
+
+// Change the per-move budget (time_ms > 0 takes priority over playouts)
+void mcts_set_budget(MCTSModel *model, int playouts, double time_ms);
+
+// Drop the search tree (the next move starts fresh)
+void mcts_reset(MCTSModel *model);
+
+// Find the best move for the side to move ('O' in the GUI). The tree
+// from the previous call is reused when board follows from it.
+int mcts_find_best_move(MCTSModel *model, char board[9]);
+
+void mcts_free(MCTSModel *model);
+
+#endif // MCTS_AI_H
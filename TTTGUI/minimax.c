@@ -1,141 +1,63 @@
 #include <stdlib.h>   // for rand()
+#include "minimax.h"
+#include "perfect_table.h"
+#include "search.h"
 
 // Check if player p ('X' or 'O') has any winning line on board b
 int winBy(char b[9], char p)
 {
-    
-    if (b[0] == p && b[1] == p && b[2] == p) return 1;
-    if (b[3] == p && b[4] == p && b[5] == p) return 1;
-    if (b[6] == p && b[7] == p && b[8] == p) return 1;
+    Bitboard bb = bb_from_chars(b);
 
-    
-    if (b[0] == p && b[3] == p && b[6] == p) return 1;
-    if (b[1] == p && b[4] == p && b[7] == p) return 1;
-    if (b[2] == p && b[5] == p && b[8] == p) return 1;
-
-    
-    if (b[0] == p && b[4] == p && b[8] == p) return 1;
-    if (b[2] == p && b[4] == p && b[6] == p) return 1;
+    if (p == 'X')
+        return bb_has_win(bb.x);
+    if (p == 'O')
+        return bb_has_win(bb.o);
 
     return 0; 
 }
 
-// Check if board has at least one empty space
-static int has_space(const char b[9])
-{
-    for (int i = 0; i < 9; i++)
-    {
-        if (b[i] != 'X' && b[i] != 'O')
-        {
-            return 1;        
-        }
-    }
-    return 0;                  // board is full
-}
+// Running totals across every search, read by the GUI's timing log
+static SearchStats total_stats = {0, 0};
 
-// Evaluate board: +10 = O wins, -10 = X wins, 0 = none/draw
-static int eval(const char b[9])
+// Minimax with optional depth cap, scored for O (the maximizing side).
+// Alpha-beta with move ordering lives in search.h; the full window keeps
+// the returned score exact, so callers can still compare moves directly.
+// Positions already solved (in any rotation/reflection) come from the
+// shared transposition table.
+static int minimax_cap(Bitboard bb, int isMax, int depth, int maxDepth)
 {
-    if (winBy((char*)b, 'O'))
-    {
-        return 10;             
-    }
-    else if (winBy((char*)b, 'X'))
-    {
-        return -10;          
-    }
-    else
-    {
-        return 0;              
-    }
-}
-
-// Minimax with optional depth cap
-static int minimax_cap(char b[9], int isMax, int depth, int maxDepth)
-{
-    int score;
-    int i;
-    int best;
+    SearchContext ctx;
     int value;
-    char save;
-
-    // First, check terminal states (win / loss / draw)
-    score = eval(b);
-
-    if (score == 10)           // O has a win on board
-    {
-        return score - depth;  // earlier wins are better
-    }
-    else if (score == -10)     // X has a win on board
-    {
-        return score + depth;  // later losses are slightly less bad
-    }
-    else if (!has_space(b))    // no empty cells → draw
-    {
-        return 0;
-    }
-
-    // Apply depth limit if maxDepth > 0
-    if (maxDepth > 0 && depth >= maxDepth)
-    {
-
-        return 0;
-    }
-
-    // Maximizing player: O
-    if (isMax)
-    {
-        best = -1000;          // very low initial score
-
-        for (i = 0; i < 9; i++)
-        {
-            if (b[i] != 'X' && b[i] != 'O')   // only try empty cells
-            {
-                save = b[i];
-                b[i] = 'O';                   // O plays here
 
-                // Next turn is X (minimizing), depth+1
-                value = minimax_cap(b, 0, depth + 1, maxDepth);
+    search_init(&ctx, maxDepth, 1);   // earlier wins are better
+    ctx.tt = tt_shared();             // reused across moves and games
+    value = search_value(&ctx, bb.o, bb.x, isMax, depth);
 
-                b[i] = save;                  // undo move
-
-                if (value > best)
-                {
-                    best = value;             // keep best score for O
-                }
-            }
-        }
-        return best;
-    }
-    // Minimizing player: X
-    else
-    {
-        best = 1000;           // very high initial score
-
-        for (i = 0; i < 9; i++)
-        {
-            if (b[i] != 'X' && b[i] != 'O')   // only try empty cells
-            {
-                save = b[i];
-                b[i] = 'X';                   // X plays here
-
-                // Next turn is O (maximizing), depth+1
-                value = minimax_cap(b, 1, depth + 1, maxDepth);
+    total_stats.nodes += ctx.stats.nodes;
+    total_stats.cutoffs += ctx.stats.cutoffs;
+    return value;
+}
 
-                b[i] = save;                  // undo move
+void minimax_get_stats(unsigned long *nodes, unsigned long *cutoffs)
+{
+    if (nodes) *nodes = total_stats.nodes;
+    if (cutoffs) *cutoffs = total_stats.cutoffs;
+}
 
-                if (value < best)
-                {
-                    best = value;             // keep lowest score for X
-                }
-            }
-        }
-        return best;
-    }
+// Build the perfect-play table up front so the first Hard move is a lookup
+void minimax_init(void)
+{
+    pt_init();
 }
 
 // Choose a move for 'O' given level: 1=Easy, 2=Medium, 3=Hard
 int findBestMoveLvl(char b[9], int level)
+{
+    return findBestMoveBB(bb_from_chars(b), level);
+}
+
+// Same as findBestMoveLvl, on a bitboard
+int findBestMoveBB(Bitboard bb, int level)
 {
     int empty[9];    
     int n;         
@@ -143,17 +65,15 @@ int findBestMoveLvl(char b[9], int level)
     int best, second;
     int move, sec;
     int value;
-    char save;
+    unsigned m;
+    Bitboard child;
 
     // Collect all empty cell indices
     n = 0;
-    for (i = 0; i < 9; i++)
+    for (m = bb_empty(bb); m; m &= m - 1)
     {
-        if (b[i] != 'X' && b[i] != 'O')
-        {
-            empty[n] = i;
-            n++;
-        }
+        empty[n] = bb_first(m);
+        n++;
     }
 
     if (n == 0)
@@ -178,13 +98,11 @@ int findBestMoveLvl(char b[9], int level)
             for (j = 0; j < n; j++)
             {
                 i = empty[j];
-                save = b[i];
-                b[i] = 'O';
+                child = bb;
+                child.o |= (uint16_t)(1u << i);
 
                 // Depth cap 1
-                value = minimax_cap(b, 0, 0, 1);
-
-                b[i] = save;
+                value = minimax_cap(child, 0, 0, 1);
 
                 if (value > best)
                 {
@@ -209,12 +127,10 @@ int findBestMoveLvl(char b[9], int level)
         for (j = 0; j < n; j++)
         {
             i = empty[j];
-            save = b[i];
-            b[i] = 'O';
-
-            value = minimax_cap(b, 0, 0, 3);
+            child = bb;
+            child.o |= (uint16_t)(1u << i);
 
-            b[i] = save;
+            value = minimax_cap(child, 0, 0, 3);
 
             if (value > best)
             {
@@ -251,21 +167,27 @@ int findBestMoveLvl(char b[9], int level)
         }
     }
 
-    // -------- Level 3: Hard (full minimax, no depth cap) --------
-    // At this level, the AI plays perfectly.
+    // -------- Level 3: Hard (perfect-play table) --------
+    // At this level, the AI plays perfectly. The table holds the same
+    // answer the uncapped search below would give.
+    move = pt_best_move_o(bb);
+    if (move >= 0)
+    {
+        return move;
+    }
+
+    // Board not reachable with O to move: fall back to full minimax
     best = -1000;
     move = empty[0];
 
     for (j = 0; j < n; j++)
     {
         i = empty[j];
-        save = b[i];
-        b[i] = 'O';
+        child = bb;
+        child.o |= (uint16_t)(1u << i);
 
         // maxDepth = 0  
-        value = minimax_cap(b, 0, 0, 0);
-
-        b[i] = save;
+        value = minimax_cap(child, 0, 0, 0);
 
         if (value > best)
         {
@@ -2,7 +2,19 @@
 #ifndef MINIMAX_H
 #define MINIMAX_H
 
+#include "bitboard.h"
+
+// Solve the perfect-play table (optional; done lazily otherwise)
+void minimax_init(void);
+
 int winBy(char b[9], char p);
 int findBestMoveLvl(char b[9], int level);
 
-#endif // MINIMAX_H
\ No newline at end of file
+// Bitboard variant used by the search; b is converted once per call
+int findBestMoveBB(Bitboard bb, int level);
+
+// Nodes visited and alpha-beta cutoffs, summed over all searches so far
+// (either pointer may be NULL)
+void minimax_get_stats(unsigned long *nodes, unsigned long *cutoffs);
+
+#endif // MINIMAX_H
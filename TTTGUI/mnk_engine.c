@@ -0,0 +1,460 @@
+#include <stdlib.h>
+#include <time.h>
+#include "mnk_engine.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#define MNK_INF (MNK_WIN + 1)
+#define MNK_MATE_ZONE (MNK_WIN - 1000)   // scores beyond this are forced results
+
+#define TT_EXACT 0
+#define TT_LOWER 1
+#define TT_UPPER 2
+
+// Search state for one mnk_search() call
+typedef struct {
+    MnkEngine *e;
+    double deadline;         // wall_ms() value to stop at, 0 = none
+    int stopped;
+    unsigned long nodes;
+    int history[2][MNK_MAX_CELLS];
+} MnkSearch;
+
+// Monotonic wall clock in ms (clock() is CPU time on POSIX)
+static double wall_ms(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+static int popcount64(uint64_t m)
+{
+    return __builtin_popcountll(m);
+}
+
+// Fixed-seed xorshift64* so hashes are the same on every run
+static uint64_t next_random(uint64_t *x)
+{
+    *x ^= *x >> 12;
+    *x ^= *x << 25;
+    *x ^= *x >> 27;
+    return *x * 0x2545F4914F6CDD1DULL;
+}
+
+int mnk_init(MnkEngine *e, int rows, int cols, int k)
+{
+    static const int dr[4] = {0, 1, 1, 1};
+    static const int dc[4] = {1, 0, 1, -1};
+    int cells = rows * cols;
+    int counts[MNK_MAX_CELLS] = {0};
+    int fill[MNK_MAX_CELLS];
+    int dist[MNK_MAX_CELLS];
+    int n, i, j, d, r, c;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+
+    if (rows < 1 || cols < 1 || cells > MNK_MAX_CELLS || k < 1 || (k > rows && k > cols))
+        return 0;
+
+    e->rows = rows;
+    e->cols = cols;
+    e->k = k;
+    e->cells = cells;
+    e->full = (cells == 64) ? ~0ULL : ((1ULL << cells) - 1);
+
+    // Every k-run in the 4 directions that fits on the board
+    e->lines = (uint64_t *)malloc((size_t)4 * cells * sizeof(uint64_t));
+    if (!e->lines)
+        return 0;
+
+    n = 0;
+    for (r = 0; r < rows; r++)
+    {
+        for (c = 0; c < cols; c++)
+        {
+            for (d = 0; d < 4; d++)
+            {
+                int er = r + dr[d] * (k - 1);
+                int ec = c + dc[d] * (k - 1);
+                uint64_t line = 0;
+
+                if (er < 0 || er >= rows || ec < 0 || ec >= cols)
+                    continue;
+                for (i = 0; i < k; i++)
+                    line |= 1ULL << ((r + dr[d] * i) * cols + (c + dc[d] * i));
+                e->lines[n++] = line;
+            }
+        }
+    }
+    e->num_lines = n;
+
+    // Lines through each cell, so a move only checks its own lines
+    for (i = 0; i < n; i++)
+        for (j = 0; j < cells; j++)
+            if (e->lines[i] & (1ULL << j))
+                counts[j]++;
+
+    e->cell_line_start[0] = 0;
+    for (j = 0; j < cells; j++)
+    {
+        e->cell_line_start[j + 1] = e->cell_line_start[j] + counts[j];
+        fill[j] = e->cell_line_start[j];
+    }
+
+    e->cell_lines = (int *)malloc((size_t)(e->cell_line_start[cells] + 1) * sizeof(int));
+    if (!e->cell_lines)
+    {
+        free(e->lines);
+        return 0;
+    }
+    for (i = 0; i < n; i++)
+        for (j = 0; j < cells; j++)
+            if (e->lines[i] & (1ULL << j))
+                e->cell_lines[fill[j]++] = i;
+
+    // Centre-first move order (insertion sort, stable by index)
+    for (j = 0; j < cells; j++)
+    {
+        int dy = 2 * (j / cols) - (rows - 1);
+        int dx = 2 * (j % cols) - (cols - 1);
+        int key = dy * dy + dx * dx;
+
+        for (i = j; i > 0 && dist[i - 1] > key; i--)
+        {
+            dist[i] = dist[i - 1];
+            e->order[i] = e->order[i - 1];
+        }
+        dist[i] = key;
+        e->order[i] = j;
+    }
+
+    for (j = 0; j < cells; j++)
+    {
+        e->zobrist[j][0] = next_random(&seed);
+        e->zobrist[j][1] = next_random(&seed);
+    }
+    e->zobrist_side = next_random(&seed);
+
+    e->tt_mask = (1u << MNK_TT_BITS) - 1;
+    e->tt = (MnkTTEntry *)calloc((size_t)1 << MNK_TT_BITS, sizeof(MnkTTEntry));
+    if (!e->tt)
+    {
+        free(e->lines);
+        free(e->cell_lines);
+        return 0;
+    }
+    return 1;
+}
+
+void mnk_free(MnkEngine *e)
+{
+    free(e->lines);
+    free(e->cell_lines);
+    free(e->tt);
+    e->lines = NULL;
+    e->cell_lines = NULL;
+    e->tt = NULL;
+}
+
+static void parse_board(const MnkEngine *e, const char *b, uint64_t *bx, uint64_t *bo)
+{
+    *bx = 0;
+    *bo = 0;
+    for (int i = 0; i < e->cells; i++)
+    {
+        if (b[i] == 'X' || b[i] == 'x')
+            *bx |= 1ULL << i;
+        else if (b[i] == 'O' || b[i] == 'o')
+            *bo |= 1ULL << i;
+    }
+}
+
+// Does mask m complete a line through cell?
+static int wins_at(const MnkEngine *e, uint64_t m, int cell)
+{
+    for (int i = e->cell_line_start[cell]; i < e->cell_line_start[cell + 1]; i++)
+    {
+        uint64_t line = e->lines[e->cell_lines[i]];
+        if ((m & line) == line)
+            return 1;
+    }
+    return 0;
+}
+
+static int has_line(const MnkEngine *e, uint64_t m)
+{
+    for (int i = 0; i < e->num_lines; i++)
+    {
+        if ((m & e->lines[i]) == e->lines[i])
+            return 1;
+    }
+    return 0;
+}
+
+int mnk_winner(const MnkEngine *e, const char *b)
+{
+    uint64_t bx, bo;
+
+    parse_board(e, b, &bx, &bo);
+    if (has_line(e, bx))
+        return 1;
+    if (has_line(e, bo))
+        return 2;
+    if ((bx | bo) == e->full)
+        return 3;
+    return 0;
+}
+
+// Static score for "me": lines still open to one side only, weighted
+// 8x per stone so near-complete lines dominate
+static int evaluate(const MnkEngine *e, uint64_t me, uint64_t opp)
+{
+    int score = 0;
+
+    for (int i = 0; i < e->num_lines; i++)
+    {
+        uint64_t line = e->lines[i];
+        int mine = popcount64(me & line);
+        int theirs = popcount64(opp & line);
+
+        if (theirs == 0 && mine > 0)
+            score += 1 << (3 * (mine < 5 ? mine : 5));
+        else if (mine == 0 && theirs > 0)
+            score -= 1 << (3 * (theirs < 5 ? theirs : 5));
+    }
+    return score;
+}
+
+// Win scores count plies from the root; the table keeps them relative
+// to the node so they stay valid wherever the position comes up again
+static int to_tt(int v, int ply)
+{
+    return v > MNK_MATE_ZONE ? v + ply : (v < -MNK_MATE_ZONE ? v - ply : v);
+}
+
+static int from_tt(int v, int ply)
+{
+    return v > MNK_MATE_ZONE ? v - ply : (v < -MNK_MATE_ZONE ? v + ply : v);
+}
+
+// Empty cells, table move first, then by history score, centre first on ties
+static int order_moves(const MnkSearch *s, uint64_t empty, int side, int tt_move, int moves[MNK_MAX_CELLS])
+{
+    const MnkEngine *e = s->e;
+    int n = 0;
+
+    for (int i = 0; i < e->cells; i++)
+    {
+        int cell = e->order[i];
+        int j;
+
+        if (!(empty & (1ULL << cell)) || cell == tt_move)
+            continue;
+        for (j = n; j > 0 && s->history[side][moves[j - 1]] < s->history[side][cell]; j--)
+            moves[j] = moves[j - 1];
+        moves[j] = cell;
+        n++;
+    }
+
+    if (tt_move >= 0 && (empty & (1ULL << tt_move)))
+    {
+        for (int j = n; j > 0; j--)
+            moves[j] = moves[j - 1];
+        moves[0] = tt_move;
+        n++;
+    }
+    return n;
+}
+
+static int negamax(MnkSearch *s, uint64_t bx, uint64_t bo, int side, uint64_t key,
+                   int depth, int ply, int alpha, int beta);
+
+// Score for the side to move of playing cell, searched depth plies deep
+static int score_move(MnkSearch *s, uint64_t bx, uint64_t bo, int side, uint64_t key,
+                      int cell, int depth, int ply, int alpha, int beta)
+{
+    const MnkEngine *e = s->e;
+    uint64_t bit = 1ULL << cell;
+    uint64_t me = (side ? bo : bx) | bit;
+    uint64_t opp = side ? bx : bo;
+
+    if (wins_at(e, me, cell))
+        return MNK_WIN - (ply + 1);
+    if ((bx | bo | bit) == e->full)
+        return 0;
+    if (depth <= 1)
+        return evaluate(e, me, opp);
+
+    if (side)
+        bo |= bit;
+    else
+        bx |= bit;
+    return -negamax(s, bx, bo, side ^ 1, key ^ e->zobrist[cell][side],
+                    depth - 1, ply + 1, -beta, -alpha);
+}
+
+// Negamax alpha-beta on a non-terminal position; score for the side to move
+static int negamax(MnkSearch *s, uint64_t bx, uint64_t bo, int side, uint64_t key,
+                   int depth, int ply, int alpha, int beta)
+{
+    MnkEngine *e = s->e;
+    uint64_t hash = side ? key ^ e->zobrist_side : key;
+    MnkTTEntry *t = &e->tt[hash & e->tt_mask];
+    int moves[MNK_MAX_CELLS];
+    int n, value;
+    int alpha0 = alpha;
+    int best = -MNK_INF;
+    int best_move = -1;
+    int tt_move = -1;
+
+    // Check the clock every 1024 nodes
+    if ((++s->nodes & 1023) == 0 && s->deadline > 0.0 && wall_ms() >= s->deadline)
+        s->stopped = 1;
+    if (s->stopped)
+        return 0;
+
+    if (t->key == hash)
+    {
+        tt_move = t->move;
+        if (t->depth >= depth)
+        {
+            value = from_tt(t->value, ply);
+            if (t->bound == TT_EXACT)
+                return value;
+            if (t->bound == TT_LOWER && value > alpha)
+                alpha = value;
+            else if (t->bound == TT_UPPER && value < beta)
+                beta = value;
+            if (alpha >= beta)
+                return value;
+        }
+    }
+
+    n = order_moves(s, e->full & ~(bx | bo), side, tt_move, moves);
+
+    for (int i = 0; i < n; i++)
+    {
+        value = score_move(s, bx, bo, side, key, moves[i], depth, ply, alpha, beta);
+        if (s->stopped)
+            return 0;
+
+        if (value > best)
+        {
+            best = value;
+            best_move = moves[i];
+        }
+        if (best > alpha)
+            alpha = best;
+        if (alpha >= beta)
+        {
+            s->history[side][moves[i]] += depth * depth;
+            break;
+        }
+    }
+
+    t->key = hash;
+    t->value = to_tt(best, ply);
+    t->depth = (int8_t)depth;
+    t->bound = (best <= alpha0) ? TT_UPPER : (best >= beta) ? TT_LOWER : TT_EXACT;
+    t->move = (int8_t)best_move;
+    return best;
+}
+
+int mnk_search(MnkEngine *e, const char *b, char player,
+               double deadline_ms, int max_depth, MnkSearchInfo *info)
+{
+    MnkSearch s = {0};
+    uint64_t bx, bo, empty, key = 0;
+    int side = (player == 'X' || player == 'x') ? 0 : 1;
+    int moves[MNK_MAX_CELLS];
+    int n, limit, depth;
+    int best_move, best_score = 0, done_depth = 0;
+    double start = wall_ms();
+
+    parse_board(e, b, &bx, &bo);
+    empty = e->full & ~(bx | bo);
+    if (!empty || has_line(e, bx) || has_line(e, bo))
+        return -1;
+
+    for (int i = 0; i < e->cells; i++)
+    {
+        if (bx & (1ULL << i))
+            key ^= e->zobrist[i][0];
+        else if (bo & (1ULL << i))
+            key ^= e->zobrist[i][1];
+    }
+
+    s.e = e;
+    if (deadline_ms > 0.0)
+        s.deadline = start + deadline_ms;
+
+    n = order_moves(&s, empty, side, -1, moves);
+    best_move = moves[0];   // answer if not even depth 1 finishes
+
+    // Going deeper than the empty cells gains nothing
+    limit = popcount64(empty);
+    if (max_depth > 0 && max_depth < limit)
+        limit = max_depth;
+
+    for (depth = 1; depth <= limit; depth++)
+    {
+        int alpha = -MNK_INF;
+        int iter_move = -1;
+
+        for (int i = 0; i < n; i++)
+        {
+            int value = score_move(&s, bx, bo, side, key, moves[i], depth, 0, alpha, MNK_INF);
+            if (s.stopped)
+                break;
+            if (value > alpha)
+            {
+                alpha = value;
+                iter_move = i;
+            }
+        }
+        if (s.stopped)
+            break;   // keep the last completed iteration
+
+        best_move = moves[iter_move];
+        best_score = alpha;
+        done_depth = depth;
+
+        // Search this iteration's best move first next time
+        for (int i = iter_move; i > 0; i--)
+            moves[i] = moves[i - 1];
+        moves[0] = best_move;
+
+        // A forced result within the searched depth is final. (One seen
+        // further out came from the table; a quicker one may still exist.)
+        if ((alpha > MNK_MATE_ZONE && MNK_WIN - alpha <= depth) ||
+            (alpha < -MNK_MATE_ZONE && MNK_WIN + alpha <= depth))
+            break;
+    }
+
+    if (info)
+    {
+        info->depth = done_depth;
+        info->score = best_score;
+        info->nodes = s.nodes;
+        info->ms = wall_ms() - start;
+    }
+    return best_move;
+}
+
+int mnk_find_best_move_lvl(MnkEngine *e, const char *b, int level)
+{
+    if (level == 1)
+        return mnk_search(e, b, 'O', 0.0, MNK_EASY_DEPTH, NULL);
+    if (level == 2)
+        return mnk_search(e, b, 'O', MNK_MEDIUM_MS, 0, NULL);
+    return mnk_search(e, b, 'O', MNK_HARD_MS, 0, NULL);
+}
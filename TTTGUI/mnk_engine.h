@@ -0,0 +1,71 @@
+// mnk_engine.h - m x n boards with k in a row (4x4/k=4, 5x5/k=4, ...)
+//
+// Boards are two 64-bit masks (cell r*cols+c), win lines are precomputed
+// masks, and moves are found by iterative-deepening alpha-beta that
+// stops at a per-move deadline. Boards use the GUI alphabet: 'X', 'O',
+// anything else is empty.
+#ifndef MNK_ENGINE_H
+#define MNK_ENGINE_H
+
+#include <stdint.h>
+
+#define MNK_MAX_CELLS 64
+#define MNK_WIN 1000000000       // win score; faster wins score higher
+#define MNK_TT_BITS 18           // 2^18 transposition entries (4 MB)
+
+// Per-level settings for mnk_find_best_move_lvl()
+#define MNK_EASY_DEPTH   2
+#define MNK_MEDIUM_MS    100.0
+#define MNK_HARD_MS      1000.0
+
+typedef struct {
+    uint64_t key;
+    int32_t  value;
+    int8_t   depth;
+    uint8_t  bound;
+    int8_t   move;
+} MnkTTEntry;
+
+typedef struct {
+    int rows, cols, k;
+    int cells;
+    uint64_t full;                      // all cells
+
+    int num_lines;
+    uint64_t *lines;                    // cells of each k-line
+    int *cell_lines;                    // line ids through each cell, packed
+    int cell_line_start[MNK_MAX_CELLS + 1];
+
+    int order[MNK_MAX_CELLS];           // cells sorted centre-first
+    uint64_t zobrist[MNK_MAX_CELLS][2];
+    uint64_t zobrist_side;              // folded in when O is to move
+
+    MnkTTEntry *tt;
+    uint32_t tt_mask;
+} MnkEngine;
+
+typedef struct {
+    int depth;                // deepest fully searched iteration
+    int score;                // score of the chosen move for the mover
+    unsigned long nodes;
+    double ms;
+} MnkSearchInfo;
+
+// Build line tables for a rows x cols board with k in a row.
+// Returns 0 for unsupported sizes (more than 64 cells, k too long).
+int mnk_init(MnkEngine *e, int rows, int cols, int k);
+void mnk_free(MnkEngine *e);
+
+// 0 = game on, 1 = X won, 2 = O won, 3 = draw
+int mnk_winner(const MnkEngine *e, const char *b);
+
+// Best move for player ('X' or 'O'). Searches deeper until deadline_ms
+// runs out (0 = no deadline) or max_depth is reached (0 = no limit).
+// info may be NULL. Returns -1 if there is no legal move.
+int mnk_search(MnkEngine *e, const char *b, char player,
+               double deadline_ms, int max_depth, MnkSearchInfo *info);
+
+// Same shape as findBestMoveLvl(): move for 'O', level 1=Easy, 2=Medium, 3=Hard
+int mnk_find_best_move_lvl(MnkEngine *e, const char *b, int level);
+
+#endif // MNK_ENGINE_H
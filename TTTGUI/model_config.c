@@ -46,6 +46,8 @@ const char* ai_config_get_model_name(AIModelType model) {
             return "Imperfect Minimax";
         case AI_MODEL_MINIMAX_HARD:
             return "Perfect Minimax";
+        case AI_MODEL_MCTS:
+            return "Monte Carlo Tree Search";
         default:
             return "Unknown";
     }
@@ -63,6 +65,8 @@ const char* ai_config_get_model_description(AIModelType model) {
             return "Imperfect search (depth 3)";
         case AI_MODEL_MINIMAX_HARD:
             return "Perfect play (full depth)";
+        case AI_MODEL_MCTS:
+            return "UCT search (playout budget)";
         default:
             return "Unknown model";
     }
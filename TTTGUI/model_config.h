@@ -6,7 +6,8 @@ typedef enum {
     AI_MODEL_LINEAR_REGRESSION,
     AI_MODEL_Q_LEARNING,
     AI_MODEL_MINIMAX_EASY,
-    AI_MODEL_MINIMAX_HARD
+    AI_MODEL_MINIMAX_HARD,
+    AI_MODEL_MCTS
 } AIModelType;
 
 typedef struct {
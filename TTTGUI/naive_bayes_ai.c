@@ -1,144 +1,135 @@
 #include "naive_bayes_ai.h"
+#include "bitboard.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <time.h>
 
-int nb_load_model(const char *filename, NaiveBayesModel *model) {
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
-        printf("Error: Could not open model file %s\n", filename);
-        return 0;
-    }
-    
-    char line[256];
-    model->label_count = 0;
-    for (int i = 0; i < MAX_FEATURES; i++) {
-        model->feature_count[i] = 0;
-    }
+#define NB_MISSING_PROB 0.001   // P(state|label) for pairs not in the file
+
+// Turn the probabilities into dense log tables so inference is adds only
+static void nb_compile(NaiveBayesModel *model) {
+    const NbModel *nb = &model->nb;
     
-    while (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, "Total labels:") != NULL) {
-            sscanf(line, "Total labels: %d", &model->label_count);
-            fgets(line, sizeof(line), fp); // Skip blank line
-            break;
+    for (int l = 0; l < nb->label_count; l++) {
+        const char *label = nb->labels[l];
+        
+        model->log_prior[l] = (float)log(nb->prior[l]);
+        if (strcmp(label, "win") == 0) {
+            model->log_weight[l] = 0.0f;
+        } else if (strcmp(label, "draw") == 0) {
+            model->log_weight[l] = (float)log(0.5);
+        } else {
+            model->log_weight[l] = (float)log(0.1);
         }
-    }
-    
-    for (int i = 0; i < model->label_count; i++) {
-        if (fgets(line, sizeof(line), fp)) {
-            sscanf(line, "Label: %s P(Label) = %lf", 
-                   model->label_probs[i].label, 
-                   &model->label_probs[i].probability);
+        
+        for (int j = 0; j < MAX_FEATURES; j++) {
+            for (int s = 0; s < NB_CELL_STATES; s++) {
+                double p = nb_has(nb, l, j, s) ? nb->prob[l][j][s] : NB_MISSING_PROB;
+                model->logp[l][j][s] = (float)log(p);
+            }
         }
     }
-    
-    int current_feature = -1;
-    while (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, "Feature") != NULL && strstr(line, ":") != NULL) {
-            int count;
-            sscanf(line, "Feature %d: (%d unique", &current_feature, &count);
-            model->feature_count[current_feature] = 0;
-        } else if (strstr(line, "State=") != NULL && current_feature >= 0) {
-            int idx = model->feature_count[current_feature];
-            sscanf(line, "  State=%s | Label=%s | P(State|Label) = %lf",
-                   model->feature_probs[current_feature][idx].state,
-                   model->feature_probs[current_feature][idx].label,
-                   &model->feature_probs[current_feature][idx].probability);
-            model->feature_count[current_feature]++;
-        }
+}
+
+int nb_load_model(const char *filename, NaiveBayesModel *model) {
+    if (!nb_load(filename, &model->nb)) {
+        printf("Error: Could not load model file %s\n", filename);
+        return 0;
     }
     
-    fclose(fp);
+    nb_compile(model);
     return 1;
 }
 
-void nb_predict(const NaiveBayesModel *model, char features[MAX_FEATURES][MAX_FEATURE_LENGTH], 
-                char *best_label, double *best_prob) {
-    double max_prob = -1.0;
-    strcpy(best_label, "draw");
+int nb_predict_cells(const NaiveBayesModel *model, const unsigned char cells[MAX_FEATURES],
+                     float *log_prob) {
+    int best = -1;
+    float best_lp = 0.0f;
     
-    for (int i = 0; i < model->label_count; i++) {
-        double prob = model->label_probs[i].probability;
-        
+    for (int l = 0; l < model->nb.label_count; l++) {
+        float lp = model->log_prior[l];
         for (int j = 0; j < MAX_FEATURES; j++) {
-            int found = 0;
-            for (int k = 0; k < model->feature_count[j]; k++) {
-                if (strcmp(model->feature_probs[j][k].state, features[j]) == 0 &&
-                    strcmp(model->feature_probs[j][k].label, model->label_probs[i].label) == 0) {
-                    prob *= model->feature_probs[j][k].probability;
-                    found = 1;
-                    break;
-                }
-            }
-            if (!found) {
-                prob *= 0.001;
-            }
+            lp += model->logp[l][j][cells[j]];
         }
-        
-        if (prob > max_prob) {
-            max_prob = prob;
-            strcpy(best_label, model->label_probs[i].label);
+        if (best < 0 || lp > best_lp) {
+            best = l;
+            best_lp = lp;
         }
     }
     
-    *best_prob = max_prob;
+    if (log_prob) *log_prob = best_lp;
+    return best;
 }
 
-static void board_to_features(const char board[9], char features[MAX_FEATURES][MAX_FEATURE_LENGTH]) {
-    for (int i = 0; i < 9; i++) {
-        if (board[i] == 'X') {
-            strcpy(features[i], "x");
-        } else if (board[i] == 'O') {
-            strcpy(features[i], "o");
-        } else {
-            strcpy(features[i], "b");
-        }
+void nb_predict(const NaiveBayesModel *model, char features[MAX_FEATURES][MAX_FEATURE_LENGTH], 
+                char *best_label, double *best_prob) {
+    unsigned char cells[MAX_FEATURES];
+    float lp;
+    
+    for (int j = 0; j < MAX_FEATURES; j++) {
+        int s = nb_cell_code(features[j]);
+        cells[j] = (unsigned char)(s < NB_CELL_STATES ? s : NB_CELL_B);
+    }
+    
+    int best = nb_predict_cells(model, cells, &lp);
+    if (best < 0) {
+        strcpy(best_label, "draw");
+        *best_prob = -1.0;
+        return;
     }
+    strcpy(best_label, model->nb.labels[best]);
+    *best_prob = exp((double)lp);
 }
 
 int nb_find_best_move(const NaiveBayesModel *model, char board[9]) {
+    Bitboard bb = bb_from_chars(board);
+    unsigned empty = bb_empty(bb);
     int empty_cells[9];
     int empty_count = 0;
     
-    for (int i = 0; i < 9; i++) {
-        if (board[i] != 'X' && board[i] != 'O') {
-            empty_cells[empty_count++] = i;
-        }
+    for (unsigned m = empty; m; m &= m - 1) {
+        empty_cells[empty_count++] = bb_first(m);
     }
     
     if (empty_count == 0) {
         return -1;
     }
     int best_move = empty_cells[0];
-    double best_win_prob = -1.0;
     
-    for (int i = 0; i < empty_count; i++) {
-        int move = empty_cells[i];
-        
-        char temp_board[9];
-        memcpy(temp_board, board, 9);
-        temp_board[move] = 'O';
-        
-        char features[MAX_FEATURES][MAX_FEATURE_LENGTH];
-        board_to_features(temp_board, features);
-        
-        char predicted_label[MAX_FEATURE_LENGTH];
-        double prob;
-        nb_predict(model, features, predicted_label, &prob);
-        
-        double score = 0.0;
-        if (strcmp(predicted_label, "win") == 0) {
-            score = prob;
-        } else if (strcmp(predicted_label, "draw") == 0) {
-            score = prob * 0.5;
-        } else {
-            score = prob * 0.1;
+    if (model->nb.label_count > 0) {
+        // Log score of the current board per label; each candidate move
+        // only swaps its cell from blank to O
+        float base[NB_MAX_LABELS];
+        for (int l = 0; l < model->nb.label_count; l++) {
+            base[l] = model->log_prior[l];
+            for (int j = 0; j < MAX_FEATURES; j++) {
+                int s = (bb.x >> j) & 1 ? NB_CELL_X : (bb.o >> j) & 1 ? NB_CELL_O : NB_CELL_B;
+                base[l] += model->logp[l][j][s];
+            }
         }
         
-        if (score > best_win_prob) {
-            best_win_prob = score;
-            best_move = move;
+        // Score = weight(label) * P(best label, board after move)
+        float best_score = 0.0f;
+        for (int i = 0; i < empty_count; i++) {
+            int move = empty_cells[i];
+            int label = 0;
+            float label_lp = 0.0f;
+            
+            for (int l = 0; l < model->nb.label_count; l++) {
+                float lp = base[l] - model->logp[l][move][NB_CELL_B] + model->logp[l][move][NB_CELL_O];
+                if (l == 0 || lp > label_lp) {
+                    label = l;
+                    label_lp = lp;
+                }
+            }
+            
+            float score = label_lp + model->log_weight[label];
+            if (i == 0 || score > best_score) {
+                best_score = score;
+                best_move = move;
+            }
         }
     }
     
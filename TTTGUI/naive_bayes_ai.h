@@ -1,32 +1,30 @@
 #ifndef NAIVE_BAYES_AI_H
 #define NAIVE_BAYES_AI_H
 
-#define MAX_FEATURES 9
-#define MAX_STATES 10
-#define MAX_LABELS 10
-#define MAX_FEATURE_LENGTH 32
+#include "nb_model.h"
 
-typedef struct {
-    char state[MAX_FEATURE_LENGTH];
-    char label[MAX_FEATURE_LENGTH];
-    double probability;
-} FeatureProbability;
+#define MAX_FEATURES NB_CELLS
+#define MAX_FEATURE_LENGTH 32
 
 typedef struct {
-    char label[MAX_FEATURE_LENGTH];
-    double probability;
-} LabelProbability;
+    NbModel nb;   // probabilities as loaded, see nb_model.h
 
-typedef struct {
-    FeatureProbability feature_probs[MAX_FEATURES][MAX_STATES * MAX_LABELS];
-    int feature_count[MAX_FEATURES];
-    LabelProbability label_probs[MAX_LABELS];
-    int label_count;
+    // Compiled by nb_load_model: log P(label), log P(cell state | label)
+    // (log 0.001 for pairs the model lacks) and log of the label's
+    // weight in move scores (win 1, draw 0.5, other 0.1)
+    float log_prior[NB_MAX_LABELS];
+    float logp[NB_MAX_LABELS][NB_CELLS][NB_CELL_STATES];
+    float log_weight[NB_MAX_LABELS];
 } NaiveBayesModel;
 
+// Loads a text model or a binary one written by the trainer
 int nb_load_model(const char *filename, NaiveBayesModel *model);
 int nb_find_best_move(const NaiveBayesModel *model, char board[9]);
 void nb_predict(const NaiveBayesModel *model, char features[MAX_FEATURES][MAX_FEATURE_LENGTH], 
                 char *best_label, double *best_prob);
+// Most likely label index for cells coded NB_CELL_*, -1 if the model has
+// no labels; *log_prob (may be NULL) gets its log joint probability
+int nb_predict_cells(const NaiveBayesModel *model, const unsigned char cells[MAX_FEATURES],
+                     float *log_prob);
 
 #endif // NAIVE_BAYES_AI_H
@@ -0,0 +1,394 @@
+// nb_model.h - compact Naive Bayes model for 3x3 Tic-Tac-Toe
+//
+// P(label) and P(cell state | label) for every label, cell and state
+// (x, o, b) in one small struct (about 2.6 KB) instead of string-keyed
+// pair lists. Label names are stored once; everything else is indexed
+// by label number, cell and NB_CELL_* code. A pair the model has no
+// value for is left out of `present`, so callers keep their own rule
+// for missing pairs.
+//
+// Files: the text format naive_bayes.c writes ("Total labels: ...") and
+// a binary format (NbFileHeader + the struct). The binary loader also
+// reads the raw struct dumps older naive_bayes.c builds wrote.
+#ifndef NB_MODEL_H
+#define NB_MODEL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define NB_CELLS 9
+#define NB_MAX_LABELS 10     // as many as the old trainer's Model held
+#define NB_LABEL_LEN 32      // label name, NUL included (e.g. "positive")
+
+// Cell state codes; NB_CELL_STATES also marks an unknown state
+#define NB_CELL_X 0
+#define NB_CELL_O 1
+#define NB_CELL_B 2
+#define NB_CELL_STATES 3
+
+#define NB_FILE_MAGIC   "TTNB"
+#define NB_FILE_VERSION 2    // 2: 10 labels of 32 characters
+
+typedef struct {
+    int label_count;
+    char labels[NB_MAX_LABELS][NB_LABEL_LEN];
+    double prior[NB_MAX_LABELS];                            // P(label)
+    double prob[NB_MAX_LABELS][NB_CELLS][NB_CELL_STATES];   // P(state | label)
+    uint32_t present[NB_MAX_LABELS];                        // bit cell * 3 + state
+} NbModel;
+
+typedef struct {
+    char magic[4];           // NB_FILE_MAGIC
+    uint32_t version;        // NB_FILE_VERSION
+    uint32_t payload_size;   // sizeof(NbModel)
+    uint32_t reserved;
+} NbFileHeader;
+
+// Layout of the Model struct older naive_bayes.c builds dumped as-is
+typedef struct {
+    char state[32];
+    char label[32];
+    double probability;
+} NbLegacyPair;
+
+typedef struct {
+    char label[32];
+    double probability;
+} NbLegacyLabel;
+
+typedef struct {
+    NbLegacyPair feature_probs[9][100];
+    int feature_count[9];
+    NbLegacyLabel label_probs[10];
+    int label_count;
+} NbLegacyModel;
+
+static inline void nb_init(NbModel *m)
+{
+    memset(m, 0, sizeof(*m));
+}
+
+// NB_CELL_* for a dataset/model state string, NB_CELL_STATES if unknown
+static inline int nb_cell_code(const char *state)
+{
+    if (strcmp(state, "x") == 0)
+        return NB_CELL_X;
+    if (strcmp(state, "o") == 0)
+        return NB_CELL_O;
+    if (strcmp(state, "b") == 0)
+        return NB_CELL_B;
+    return NB_CELL_STATES;
+}
+
+// NB_CELL_* for a board cell in either alphabet
+static inline int nb_cell_from_char(char c)
+{
+    if (c == 'X' || c == 'x')
+        return NB_CELL_X;
+    if (c == 'O' || c == 'o')
+        return NB_CELL_O;
+    return NB_CELL_B;
+}
+
+static inline int nb_label_index(const NbModel *m, const char *name)
+{
+    for (int l = 0; l < m->label_count; l++)
+    {
+        if (strcmp(m->labels[l], name) == 0)
+            return l;
+    }
+    return -1;
+}
+
+// Index of name, added if new; -1 if the name is too long or the
+// model already has NB_MAX_LABELS labels
+static inline int nb_intern_label(NbModel *m, const char *name)
+{
+    int l = nb_label_index(m, name);
+
+    if (l >= 0)
+        return l;
+    if (m->label_count == NB_MAX_LABELS || strlen(name) >= NB_LABEL_LEN)
+        return -1;
+    strcpy(m->labels[m->label_count], name);
+    return m->label_count++;
+}
+
+static inline int nb_has(const NbModel *m, int l, int cell, int state)
+{
+    return state < NB_CELL_STATES && ((m->present[l] >> (cell * NB_CELL_STATES + state)) & 1);
+}
+
+static inline void nb_set(NbModel *m, int l, int cell, int state, double p)
+{
+    m->prob[l][cell][state] = p;
+    m->present[l] |= 1u << (cell * NB_CELL_STATES + state);
+}
+
+// Most likely label for cells coded NB_CELL_*, -1 if the model has no
+// labels. Multiplies P(label) by P(state | label) cell by cell, using
+// `missing` for pairs the model lacks; the first label wins ties.
+// *prob (may be NULL) gets the winning product.
+static inline int nb_predict_label(const NbModel *m, const unsigned char cells[NB_CELLS],
+                                   double missing, double *prob)
+{
+    int best = -1;
+    double best_p = -1.0;
+
+    for (int l = 0; l < m->label_count; l++)
+    {
+        double p = m->prior[l];
+        for (int j = 0; j < NB_CELLS; j++)
+            p *= nb_has(m, l, j, cells[j]) ? m->prob[l][j][cells[j]] : missing;
+        if (p > best_p)
+        {
+            best_p = p;
+            best = l;
+        }
+    }
+    if (prob)
+        *prob = best_p;
+    return best;
+}
+
+// Text format. Returns 1 once the file is read (a file with no label
+// section gives an empty model), 0 if it cannot be opened or has more
+// labels than NbModel holds. For a repeated pair the first one counts.
+static inline int nb_load_text(const char *path, NbModel *m)
+{
+    FILE *fp = fopen(path, "r");
+    char line[256], state[32], label[32];
+    int labels = 0, feature = -1, ok = 1;
+    double p;
+
+    nb_init(m);
+    if (!fp)
+        return 0;
+
+    while (fgets(line, sizeof(line), fp))
+    {
+        if (sscanf(line, "Total labels: %d", &labels) == 1)
+        {
+            if (!fgets(line, sizeof(line), fp))   // blank line
+                labels = 0;
+            break;
+        }
+    }
+    for (int i = 0; i < labels && ok; i++)
+    {
+        if (!fgets(line, sizeof(line), fp))
+            break;
+        if (sscanf(line, "Label: %31s P(Label) = %lf", label, &p) == 2)
+        {
+            int l = nb_intern_label(m, label);
+            if (l < 0)
+                ok = 0;
+            else
+                m->prior[l] = p;
+        }
+    }
+
+    while (ok && fgets(line, sizeof(line), fp))
+    {
+        if (strstr(line, "Feature") != NULL && strstr(line, ":") != NULL)
+        {
+            if (sscanf(line, "Feature %d:", &feature) != 1 || feature < 0 || feature >= NB_CELLS)
+                feature = -1;
+        }
+        else if (strstr(line, "State=") != NULL && feature >= 0)
+        {
+            if (sscanf(line, "  State=%31s | Label=%31s | P(State|Label) = %lf", state, label, &p) == 3)
+            {
+                int l = nb_label_index(m, label);
+                int s = nb_cell_code(state);
+                if (l >= 0 && s < NB_CELL_STATES && !nb_has(m, l, feature, s))
+                    nb_set(m, l, feature, s, p);
+            }
+        }
+    }
+
+    fclose(fp);
+    if (!ok)
+        nb_init(m);
+    return ok;
+}
+
+// Same layout as the old trainer output: labels, then the pairs of each cell
+static inline int nb_save_text(const char *path, const NbModel *m)
+{
+    FILE *fp = fopen(path, "w");
+
+    if (!fp)
+        return 0;
+
+    fprintf(fp, "========================================\n");
+    fprintf(fp, "NAIVE BAYES MODEL\n");
+    fprintf(fp, "========================================\n\n");
+
+    fprintf(fp, "LABEL PROBABILITIES\n");
+    fprintf(fp, "----------------------------------------\n");
+    fprintf(fp, "Total labels: %d\n\n", m->label_count);
+    for (int l = 0; l < m->label_count; l++)
+        fprintf(fp, "Label: %-10s P(Label) = %.6f\n", m->labels[l], m->prior[l]);
+
+    fprintf(fp, "\n\nFEATURE PROBABILITIES\n");
+    fprintf(fp, "========================================\n");
+
+    for (int j = 0; j < NB_CELLS; j++)
+    {
+        static const char *const names[NB_CELL_STATES] = {"x", "o", "b"};
+        int pairs = 0;
+
+        for (int l = 0; l < m->label_count; l++)
+        {
+            for (int s = 0; s < NB_CELL_STATES; s++)
+                pairs += nb_has(m, l, j, s);
+        }
+        if (pairs == 0)
+            continue;
+
+        fprintf(fp, "\nFeature %d: (%d unique state-label pairs)\n", j, pairs);
+        fprintf(fp, "----------------------------------------\n");
+        for (int l = 0; l < m->label_count; l++)
+        {
+            for (int s = 0; s < NB_CELL_STATES; s++)
+            {
+                if (nb_has(m, l, j, s))
+                    fprintf(fp, "  State=%-5s | Label=%-10s | P(State|Label) = %.6f\n",
+                            names[s], m->labels[l], m->prob[l][j][s]);
+            }
+        }
+    }
+
+    fprintf(fp, "\n========================================\n");
+    fprintf(fp, "END OF MODEL\n");
+    fprintf(fp, "========================================\n");
+
+    return fclose(fp) == 0;
+}
+
+static inline int nb_save_binary(const char *path, const NbModel *m)
+{
+    NbFileHeader h;
+    FILE *fp = fopen(path, "wb");
+    int ok;
+
+    if (!fp)
+        return 0;
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, NB_FILE_MAGIC, 4);
+    h.version = NB_FILE_VERSION;
+    h.payload_size = sizeof(NbModel);
+
+    ok = fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(m, sizeof(*m), 1, fp) == 1;
+    if (fclose(fp) != 0)
+        ok = 0;
+    return ok;
+}
+
+// Convert an old raw dump; 0 if it has more labels than NbModel holds
+static inline int nb_from_legacy(const NbLegacyModel *old, NbModel *m)
+{
+    nb_init(m);
+    if (old->label_count < 0 || old->label_count > NB_MAX_LABELS)
+        return 0;
+
+    for (int i = 0; i < old->label_count; i++)
+    {
+        char name[32];
+        int l;
+
+        memcpy(name, old->label_probs[i].label, sizeof(name));
+        name[sizeof(name) - 1] = '\0';
+        l = nb_intern_label(m, name);
+        if (l < 0)
+            return 0;
+        m->prior[l] = old->label_probs[i].probability;
+    }
+
+    for (int j = 0; j < NB_CELLS; j++)
+    {
+        int count = old->feature_count[j];
+
+        for (int k = 0; k < count && k < 100; k++)
+        {
+            NbLegacyPair pair = old->feature_probs[j][k];
+            int l, s;
+
+            pair.state[31] = pair.label[31] = '\0';
+            l = nb_label_index(m, pair.label);
+            s = nb_cell_code(pair.state);
+            if (l >= 0 && s < NB_CELL_STATES && !nb_has(m, l, j, s))
+                nb_set(m, l, j, s, pair.probability);
+        }
+    }
+    return 1;
+}
+
+// Binary file in either layout. Returns 1 on success, else leaves m
+// empty and returns 0.
+static inline int nb_load_binary(const char *path, NbModel *m)
+{
+    FILE *fp = fopen(path, "rb");
+    NbFileHeader h;
+    long size;
+    int ok = 0;
+
+    nb_init(m);
+    if (!fp)
+        return 0;
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    rewind(fp);
+
+    if (size == (long)(sizeof(NbFileHeader) + sizeof(NbModel)))
+    {
+        ok = fread(&h, sizeof(h), 1, fp) == 1 && memcmp(h.magic, NB_FILE_MAGIC, 4) == 0 &&
+             h.version == NB_FILE_VERSION && h.payload_size == sizeof(NbModel) &&
+             fread(m, sizeof(*m), 1, fp) == 1 &&
+             m->label_count >= 0 && m->label_count <= NB_MAX_LABELS;
+    }
+    else if (size == (long)sizeof(NbLegacyModel))
+    {
+        NbLegacyModel *old = malloc(sizeof(*old));
+        if (old)
+        {
+            ok = fread(old, sizeof(*old), 1, fp) == 1 && nb_from_legacy(old, m);
+            free(old);
+        }
+    }
+
+    fclose(fp);
+    if (!ok)
+        nb_init(m);
+    return ok;
+}
+
+// Is this a binary model (either layout) rather than a text one?
+static inline int nb_is_binary_file(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    char magic[4];
+    long size;
+    int binary;
+
+    if (!fp)
+        return 0;
+    binary = fread(magic, 1, 4, fp) == 4 && memcmp(magic, NB_FILE_MAGIC, 4) == 0;
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fclose(fp);
+    return binary || size == (long)sizeof(NbLegacyModel);
+}
+
+// Binary or text, by content
+static inline int nb_load(const char *path, NbModel *m)
+{
+    return nb_is_binary_file(path) ? nb_load_binary(path, m) : nb_load_text(path, m);
+}
+
+#endif // NB_MODEL_H
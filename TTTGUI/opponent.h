@@ -0,0 +1,118 @@
+// opponent.h - table-backed opponent policies for the Q-learning trainers
+//
+// An opponent answers "which cell does the side to move take on this
+// board?" from a dense table indexed by the base-3 board index. Entries
+// are searched on first use and then reused by every later episode, so
+// a trainer pays for each position once instead of once per visit.
+// Side to move follows the piece counts (X moves first).
+//
+//   random   uniform over the empty cells (nothing to cache)
+//   depth2   depth-limited minimax, 2 plies after the move
+//   depth4   same, 4 plies (the trainers' original opponent)
+//   perfect  full-depth play from perfect_table.h
+//
+// The depth-limited policies pick what the trainers' minimax_move() did:
+// the lowest cell with the best flat (+/-10) score from search.h.
+#ifndef OPPONENT_H
+#define OPPONENT_H
+
+#include <string.h>
+#include "search.h"
+#include "perfect_table.h"
+
+#define OPP_UNSOLVED (-2)   // move[] entry not searched yet
+
+typedef enum
+{
+    OPP_RANDOM,
+    OPP_DEPTH2,
+    OPP_DEPTH4,
+    OPP_PERFECT,
+    OPP_KINDS
+} OpponentKind;
+
+static const char *const OPP_NAMES[OPP_KINDS] = {"random", "depth2", "depth4", "perfect"};
+
+typedef struct {
+    OpponentKind kind;
+    int depth_limit;             // plies searched after the move (depth kinds)
+    int8_t move[BB_STATES];      // cell, -1 for no move, OPP_UNSOLVED
+    int solved;                  // boards searched so far
+    SearchStats stats;           // search work spent filling the table
+} OpponentPolicy;
+
+static inline void opp_init(OpponentPolicy *p, OpponentKind kind)
+{
+    memset(p, 0, sizeof(*p));
+    memset(p->move, OPP_UNSOLVED, sizeof(p->move));
+    p->kind = kind;
+    p->depth_limit = kind == OPP_DEPTH2 ? 2 : kind == OPP_DEPTH4 ? 4 : 0;
+}
+
+// Kind for a name in OPP_NAMES, or -1
+static inline int opp_parse(const char *name)
+{
+    for (int k = 0; k < OPP_KINDS; k++)
+    {
+        if (strcmp(name, OPP_NAMES[k]) == 0)
+            return k;
+    }
+    return -1;
+}
+
+// Depth-limited move for the side to move: first cell with the best score
+static int opp_search(OpponentPolicy *p, Bitboard bb)
+{
+    int x_to_move = bb_popcount(bb.x) == bb_popcount(bb.o);
+    uint16_t me = x_to_move ? bb.x : bb.o;
+    uint16_t opp = x_to_move ? bb.o : bb.x;
+    unsigned empty = bb_empty(bb);
+    int best_move = empty ? bb_first(empty) : -1;
+    int best_eval = -SEARCH_INF;
+
+    for (unsigned m = empty; m; m &= m - 1)
+    {
+        int cell = bb_first(m);
+        SearchContext ctx;
+
+        search_init(&ctx, p->depth_limit, 0);
+        ctx.tt = tt_shared();
+        int eval = search_value(&ctx, me | (uint16_t)(1u << cell), opp, 0, 0);
+        p->stats.nodes += ctx.stats.nodes;
+        p->stats.cutoffs += ctx.stats.cutoffs;
+
+        if (eval > best_eval)
+        {
+            best_eval = eval;
+            best_move = cell;
+        }
+    }
+    return best_move;
+}
+
+// Move for the side to move, or -1 when the board is full. rnd is any
+// random number from the caller; only the random policy uses it.
+static inline int opp_move(OpponentPolicy *p, Bitboard bb, unsigned rnd)
+{
+    unsigned empty = bb_empty(bb);
+    int s;
+
+    if (!empty)
+        return -1;
+    if (p->kind == OPP_RANDOM)
+    {
+        for (int skip = (int)(rnd % (unsigned)bb_popcount(empty)); skip > 0; skip--)
+            empty &= empty - 1;
+        return bb_first(empty);
+    }
+
+    s = bb_index(bb);
+    if (p->move[s] == OPP_UNSOLVED)
+    {
+        p->move[s] = (int8_t)(p->kind == OPP_PERFECT ? pt_best_move(bb) : opp_search(p, bb));
+        p->solved++;
+    }
+    return p->move[s];
+}
+
+#endif // OPPONENT_H
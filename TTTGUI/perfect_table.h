@@ -0,0 +1,117 @@
+// perfect_table.h - precomputed perfect-play table for 3x3 Tic-Tac-Toe
+//
+// Every base-3 board encoding gets the best move for the side to move
+// and its minimax score, solved once on first use by walking positions
+// from full boards back to the empty board. Scores use the same scale
+// as minimax_cap(): +10 - plies for an O win, -10 + plies for an X win,
+// 0 for a draw. Side to move follows the piece counts (X moves first).
+// The table costs 2 bytes per encoding (~38 KB).
+#ifndef PERFECT_TABLE_H
+#define PERFECT_TABLE_H
+
+#include "bitboard.h"
+
+#define PT_NO_MOVE 0xFF
+
+typedef struct {
+    int8_t  value;   // minimax score of the position
+    uint8_t move;    // best cell for the side to move, PT_NO_MOVE if none
+} PerfectEntry;
+
+static PerfectEntry pt_table[BB_STATES];
+static int pt_ready = 0;
+
+static const int PT_POW3[9] = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+
+// Score of a child seen one ply further from the root
+static inline int pt_shift(int v)
+{
+    return v > 0 ? v - 1 : (v < 0 ? v + 1 : 0);
+}
+
+// Solve all encodings, deepest positions first so children are ready
+static void pt_init(void)
+{
+    if (pt_ready)
+        return;
+
+    for (int pieces = 9; pieces >= 0; pieces--)
+    {
+        for (int idx = 0; idx < BB_STATES; idx++)
+        {
+            Bitboard bb = bb_from_index(idx);
+            int nx = bb_popcount(bb.x);
+            int no = bb_popcount(bb.o);
+            PerfectEntry *e = &pt_table[idx];
+
+            if (nx + no != pieces)
+                continue;
+
+            e->move = PT_NO_MOVE;
+            e->value = 0;
+
+            if (bb_has_win(bb.o))
+            {
+                e->value = 10;
+                continue;
+            }
+            if (bb_has_win(bb.x))
+            {
+                e->value = -10;
+                continue;
+            }
+            if (bb_is_full(bb) || (nx != no && nx != no + 1))
+                continue;   // draw, or a count no game can reach
+
+            // O to move maximizes, X to move minimizes. Ties keep the
+            // lowest cell, matching the search loop order.
+            int o_turn = (nx == no + 1);
+            int best = o_turn ? -1000 : 1000;
+
+            for (unsigned m = bb_empty(bb); m; m &= m - 1)
+            {
+                int cell = bb_first(m);
+                int child = idx + PT_POW3[cell] * (o_turn ? 2 : 1);
+                int v = pt_table[child].value;
+
+                if (o_turn ? (v > best) : (v < best))
+                {
+                    best = v;
+                    e->move = (uint8_t)cell;
+                }
+            }
+            e->value = (int8_t)pt_shift(best);
+        }
+    }
+
+    pt_ready = 1;
+}
+
+static inline const PerfectEntry *pt_lookup(Bitboard bb)
+{
+    if (!pt_ready)
+        pt_init();
+    return &pt_table[bb_index(bb)];
+}
+
+// Best move for whoever is to move, or -1 for terminal/unreachable boards
+static inline int pt_best_move(Bitboard bb)
+{
+    const PerfectEntry *e = pt_lookup(bb);
+    return e->move == PT_NO_MOVE ? -1 : e->move;
+}
+
+// Best move only when the counts say it is O's turn
+static inline int pt_best_move_o(Bitboard bb)
+{
+    if (bb_popcount(bb.x) != bb_popcount(bb.o) + 1)
+        return -1;
+    return pt_best_move(bb);
+}
+
+static inline int pt_value(Bitboard bb)
+{
+    return pt_lookup(bb)->value;
+}
+
+#endif // PERFECT_TABLE_H
@@ -1,63 +1,118 @@
 #include "q_learning_ai.h"
+#include "qtable_file.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-static unsigned long hash_board(char board[9]) {
-    unsigned long hash = 5381;
-    for (int i = 0; i < 9; i++) {
-        hash = ((hash << 5) + hash) + board[i];
-    }
-    return hash % Q_TABLE_SIZE;
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static void init_model(QLearningModel *model) {
+    model->table = NULL;
+    model->parsed = NULL;
+    model->map_base = NULL;
+    model->map_size = 0;
 }
 
-static void init_qtable(QLearningModel *model) {
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        model->table[i] = NULL;
-    }
-    model->total_entries = 0;
+static void add_q_entry(QTable *qt, char board[9], int action, double q_value, int visits) {
+    if (action < 0 || action >= 9) return;
+    qt_set(qt, qt_state(board), action, (float)q_value, visits);
 }
 
-static double get_q_value(const QLearningModel *model, char board[9], int action) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = model->table[hash];
-    
-    while (entry != NULL) {
-        if (entry->action == action && 
-            memcmp(entry->board, board, 9) == 0) {
-            return entry->q_value;
+// Map a .qtb file read-only; the table is used straight from the mapping
+static int map_binary_model(const char *filename, QLearningModel *model) {
+    void *base = NULL;
+    size_t size = 0;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER len;
+        if (GetFileSizeEx(file, &len)) {
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping) {
+                base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                size = (size_t)len.QuadPart;
+                CloseHandle(mapping);   // the view keeps the mapping alive
+            }
         }
-        entry = entry->next;
+        CloseHandle(file);
     }
-    
-    return 0.0;
-}
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (base == MAP_FAILED) {
+                base = NULL;
+            } else {
+                size = (size_t)st.st_size;
+            }
+        }
+        close(fd);   // the mapping stays valid
+    }
+#endif
 
-static void add_q_entry(QLearningModel *model, char board[9], int action, double q_value, int visits) {
-    unsigned long hash = hash_board(board);
-    
-    QEntry *new_entry = (QEntry *)malloc(sizeof(QEntry));
-    memcpy(new_entry->board, board, 9);
-    new_entry->action = action;
-    new_entry->q_value = q_value;
-    new_entry->visits = visits;
-    new_entry->next = model->table[hash];
-    model->table[hash] = new_entry;
-    model->total_entries++;
+    if (!base) {
+        printf("Error: Could not map Q-Learning model file %s\n", filename);
+        return 0;
+    }
+
+    model->map_base = base;
+    model->map_size = size;
+
+    const QtFileHeader *header = (const QtFileHeader *)base;
+    const char *err = qt_check_file(header, header + 1, size);
+    if (err) {
+        printf("Error: Q-Learning model %s: %s\n", filename, err);
+        ql_free_model(model);
+        return 0;
+    }
+
+    model->table = (const QTable *)(header + 1);
+    if (model->table->symmetric) {
+        qt_canon_init();
+    }
+    printf("Q-Learning model mapped successfully: %d entries\n", model->table->total_entries);
+    return (model->table->total_entries > 0);
 }
 
 int ql_load_model(const char *filename, QLearningModel *model) {
+    init_model(model);
+    
+    if (qt_is_binary_file(filename)) {
+        return map_binary_model(filename, model);
+    }
+    
     FILE *fp = fopen(filename, "r");
     if (!fp) {
         printf("Error: Could not open Q-Learning model file %s\n", filename);
         return 0;
     }
     
-    init_qtable(model);
+    QTable *qt = (QTable *)malloc(sizeof(QTable));
+    if (!qt) {
+        fclose(fp);
+        return 0;
+    }
+    qt_init(qt);
+    model->parsed = qt;
+    model->table = qt;
     
     char line[256];
     while (fgets(line, sizeof(line), fp)) {
         if (line[0] != '#') break;
+        if (strncmp(line, QT_SYMMETRIC_TAG, strlen(QT_SYMMETRIC_TAG)) == 0) {
+            qt_set_symmetric(qt, 1);   // entries are for canonical boards
+        }
     }
     
     int entries_loaded = 0;
@@ -82,7 +137,7 @@ int ql_load_model(const char *filename, QLearningModel *model) {
                 token = strtok(NULL, ",");
                 if (token != NULL) {
                     visits = atoi(token);
-                    add_q_entry(model, board, action, q_value, visits);
+                    add_q_entry(qt, board, action, q_value, visits);
                     entries_loaded++;
                 }
             }
@@ -91,62 +146,30 @@ int ql_load_model(const char *filename, QLearningModel *model) {
     
     fclose(fp);
     printf("Q-Learning model loaded successfully: %d entries\n", entries_loaded);
-    return (model->total_entries > 0);
-}
-
-static void convert_board_format(const char *game_board, char *q_board) {
-    for (int i = 0; i < 9; i++) {
-        if (game_board[i] == 'X') {
-            q_board[i] = 'x';
-        } else if (game_board[i] == 'O') {
-            q_board[i] = 'o';
-        } else {
-            q_board[i] = 'b';
-        }
-    }
+    return (qt->total_entries > 0);
 }
 
 int ql_find_best_move(const QLearningModel *model, char board[9]) {
-    int empty_cells[9];
-    int empty_count = 0;
+    Bitboard bb = bb_from_chars(board);
+    unsigned moves = bb_empty(bb);
     
-    for (int i = 0; i < 9; i++) {
-        if (board[i] != 'X' && board[i] != 'O') {
-            empty_cells[empty_count++] = i;
-        }
-    }
-    
-    if (empty_count == 0) {
+    if (moves == 0 || !model->table) {
         return -1;
     }
-    char q_board[9];
-    convert_board_format(board, q_board);
     
-    int best_move = empty_cells[0];
-    double best_q = -1000.0;
-    
-    for (int i = 0; i < empty_count; i++) {
-        int move = empty_cells[i];
-        double q_val = get_q_value(model, q_board, move);
-        
-        if (q_val > best_q) {
-            best_q = q_val;
-            best_move = move;
-        }
-    }
-    
-    return best_move;
+    // One row holds every move's value (a symmetric model's row is mapped
+    // back to this board's orientation)
+    return qt_best_move(model->table, bb_index(bb), moves);
 }
 
 void ql_free_model(QLearningModel *model) {
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        QEntry *entry = model->table[i];
-        while (entry != NULL) {
-            QEntry *temp = entry;
-            entry = entry->next;
-            free(temp);
-        }
-        model->table[i] = NULL;
+    if (model->map_base) {
+#ifdef _WIN32
+        UnmapViewOfFile(model->map_base);
+#else
+        munmap(model->map_base, model->map_size);
+#endif
     }
-    model->total_entries = 0;
+    free(model->parsed);
+    init_model(model);
 }
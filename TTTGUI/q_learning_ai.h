@@ -1,21 +1,17 @@
 #ifndef Q_LEARNING_AI_H
 #define Q_LEARNING_AI_H
 
-#define Q_TABLE_SIZE 20000
-
-typedef struct QEntry {
-    char board[9];
-    int action;
-    double q_value;
-    int visits;
-    struct QEntry *next;
-} QEntry;
+#include <stddef.h>
+#include "qtable.h"
 
 typedef struct {
-    QEntry *table[Q_TABLE_SIZE];
-    int total_entries;
+    const QTable *table;   // one row per board, see qtable.h
+    QTable *parsed;        // heap table built from a text model, else NULL
+    void *map_base;        // mapping of a binary (.qtb) model, else NULL
+    size_t map_size;
 } QLearningModel;
 
+// Loads a binary .qtb model (memory-mapped, used in place) or a text model
 int ql_load_model(const char *filename, QLearningModel *model);
 int ql_find_best_move(const QLearningModel *model, char board[9]);
 void ql_free_model(QLearningModel *model);
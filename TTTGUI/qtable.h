@@ -0,0 +1,243 @@
+// qtable.h - direct-indexed Q-table for 3x3 Tic-Tac-Toe
+//
+// One row of 9 action values per board, addressed by the base-3 index
+// from bitboard.h, so looking at every move of a board reads one row
+// instead of walking a hash chain per move. Pairs that were never set
+// read as 0.0 and are left out when a table is saved.
+//
+// A symmetric table keeps values only for canonical boards (symmetry.h):
+// the 8 rotations/reflections of a board share one row, with moves
+// mapped through the same transform. Go through qt_key() (or the
+// qt_value / qt_best_move helpers) when a table may be symmetric.
+//
+// A QTable is about 1.4 MB: make it static or malloc it, not a local.
+#ifndef QTABLE_H
+#define QTABLE_H
+
+#include <string.h>
+#include "symmetry.h"
+
+// Header line marking a symmetric table in the text model format
+#define QT_SYMMETRIC_TAG "# Symmetry: canonical boards only"
+
+typedef struct {
+    float q[BB_STATES][BB_CELLS];
+    int visits[BB_STATES][BB_CELLS];
+    uint16_t present[BB_STATES];   // bit a set once (state, a) has a value
+    int total_entries;             // (state, action) pairs with a value
+    int symmetric;                 // 1: rows for canonical boards only
+} QTable;
+
+// Where a board's values live: row `state`, where cell a of the board
+// is entry SYM_PERM[sym][a]. sym is 0 unless the table is symmetric.
+typedef struct {
+    int state;
+    int sym;
+} QtKey;
+
+// Canonical board and symmetry for every board index, built once
+static int16_t qt_canon_state[BB_STATES];
+static uint8_t qt_canon_sym[BB_STATES];
+static int qt_canon_ready = 0;
+
+static inline void qt_canon_init(void)
+{
+    if (qt_canon_ready)
+        return;
+    for (int i = 0; i < BB_STATES; i++)
+    {
+        int s;
+        Bitboard c = sym_canonical(bb_from_index(i), &s);
+        qt_canon_state[i] = (int16_t)bb_index(c);
+        qt_canon_sym[i] = (uint8_t)s;
+    }
+    qt_canon_ready = 1;
+}
+
+static inline void qt_init(QTable *qt)
+{
+    memset(qt, 0, sizeof(*qt));
+}
+
+// Switch an empty table to symmetric rows. Call before sharing the table
+// between threads (it builds the canonical lookup on first use).
+static inline void qt_set_symmetric(QTable *qt, int on)
+{
+    qt->symmetric = on ? 1 : 0;
+    if (on)
+        qt_canon_init();
+}
+
+static inline QtKey qt_key(const QTable *qt, int state)
+{
+    QtKey k = {state, 0};
+
+    if (qt->symmetric)
+    {
+        qt_canon_init();
+        k.state = qt_canon_state[state];
+        k.sym = qt_canon_sym[state];
+    }
+    return k;
+}
+
+static inline int qt_key_action(QtKey k, int a)
+{
+    return SYM_PERM[k.sym][a];
+}
+
+// A mask of board cells as cells of the key's row
+static inline unsigned qt_key_moves(QtKey k, unsigned moves)
+{
+    return k.sym ? sym_apply_mask((uint16_t)moves, k.sym) : moves;
+}
+
+// Values of the key's row put back in board orientation
+static inline void qt_key_row(QtKey k, const float *row, float out[BB_CELLS])
+{
+    for (int a = 0; a < BB_CELLS; a++)
+        out[a] = row[SYM_PERM[k.sym][a]];
+}
+
+// Row index of a board in either cell alphabet
+static inline int qt_state(const char board[9])
+{
+    return bb_index(bb_from_chars(board));
+}
+
+static inline int qt_has(const QTable *qt, int s, int a)
+{
+    return (qt->present[s] >> a) & 1;
+}
+
+// Store a value and count a visit (a training update)
+static inline void qt_update(QTable *qt, int s, int a, float value)
+{
+    if (!qt_has(qt, s, a))
+    {
+        qt->present[s] |= (uint16_t)(1u << a);
+        qt->total_entries++;
+    }
+    qt->q[s][a] = value;
+    qt->visits[s][a]++;
+}
+
+// Store a value read from a model file; a repeated pair keeps the last one
+static inline void qt_set(QTable *qt, int s, int a, float value, int visits)
+{
+    if (!qt_has(qt, s, a))
+    {
+        qt->present[s] |= (uint16_t)(1u << a);
+        qt->total_entries++;
+    }
+    qt->q[s][a] = value;
+    qt->visits[s][a] = visits;
+}
+
+// Highest-valued cell of row among moves (a non-empty cell mask);
+// lowest cell wins ties
+static inline int qt_row_best(const float *row, unsigned moves)
+{
+    int best = bb_first(moves);
+
+    for (moves &= moves - 1; moves; moves &= moves - 1)
+    {
+        int a = bb_first(moves);
+        if (row[a] > row[best])
+            best = a;
+    }
+    return best;
+}
+
+static inline int qt_best_action(const QTable *qt, int s, unsigned moves)
+{
+    return qt_row_best(qt->q[s], moves);
+}
+
+// max over moves of Q(s, a); 0.0 when there are no moves
+static inline float qt_max_q(const QTable *qt, int s, unsigned moves)
+{
+    return moves ? qt->q[s][qt_best_action(qt, s, moves)] : 0.0f;
+}
+
+// Hogwild access, for a table that several training threads update at
+// once without locks. Values are read and written with relaxed atomics,
+// so no thread sees a torn float, but two updates of the same pair can
+// race and one of them is lost, which Q-learning tolerates. Counts and
+// the present bits are updated atomically and stay exact.
+static inline void qt_snapshot_row(const QTable *qt, int s, float row[BB_CELLS])
+{
+    for (int a = 0; a < BB_CELLS; a++)
+        __atomic_load(&qt->q[s][a], &row[a], __ATOMIC_RELAXED);
+}
+
+static inline float qt_get_shared(const QTable *qt, int s, int a)
+{
+    float v;
+    __atomic_load(&qt->q[s][a], &v, __ATOMIC_RELAXED);
+    return v;
+}
+
+static inline void qt_update_shared(QTable *qt, int s, int a, float value)
+{
+    uint16_t bit = (uint16_t)(1u << a);
+
+    if (!(__atomic_fetch_or(&qt->present[s], bit, __ATOMIC_RELAXED) & bit))
+        __atomic_fetch_add(&qt->total_entries, 1, __ATOMIC_RELAXED);
+    __atomic_store(&qt->q[s][a], &value, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&qt->visits[s][a], 1, __ATOMIC_RELAXED);
+}
+
+// Copy of a table that other threads may be updating; each value is
+// read atomically, but the copy is not one instant of the whole table
+static inline void qt_snapshot(QTable *dst, const QTable *src)
+{
+    for (int s = 0; s < BB_STATES; s++)
+    {
+        qt_snapshot_row(src, s, dst->q[s]);
+        for (int a = 0; a < BB_CELLS; a++)
+            dst->visits[s][a] = __atomic_load_n(&src->visits[s][a], __ATOMIC_RELAXED);
+        dst->present[s] = __atomic_load_n(&src->present[s], __ATOMIC_RELAXED);
+    }
+    dst->total_entries = __atomic_load_n(&src->total_entries, __ATOMIC_RELAXED);
+    dst->symmetric = src->symmetric;
+}
+
+// Board-level access (board index + board cell) for plain or symmetric
+// tables, single-threaded
+static inline float qt_value(const QTable *qt, int state, int a)
+{
+    QtKey k = qt_key(qt, state);
+    return qt->q[k.state][qt_key_action(k, a)];
+}
+
+static inline void qt_update_value(QTable *qt, int state, int a, float value)
+{
+    QtKey k = qt_key(qt, state);
+    qt_update(qt, k.state, qt_key_action(k, a), value);
+}
+
+// Best of the board's empty cells (moves, non-empty), in board orientation
+static inline int qt_best_move(const QTable *qt, int state, unsigned moves)
+{
+    QtKey k = qt_key(qt, state);
+    float row[BB_CELLS];
+
+    if (k.sym == 0)
+        return qt_row_best(qt->q[k.state], moves);
+    qt_key_row(k, qt->q[k.state], row);
+    return qt_row_best(row, moves);
+}
+
+static inline float qt_best_value(const QTable *qt, int state, unsigned moves)
+{
+    return moves ? qt_value(qt, state, qt_best_move(qt, state, moves)) : 0.0f;
+}
+
+// Board for a row index in the trainers' alphabet ('x', 'o', 'b')
+static inline void qt_board(int s, char out[9])
+{
+    bb_to_chars(bb_from_index(s), out, 'x', 'o', 'b');
+}
+
+#endif // QTABLE_H
@@ -0,0 +1,141 @@
+// qtable_file.h - binary Q-table model files (.qtb)
+//
+// A 64-byte header followed by the QTable struct exactly as it sits in
+// memory, so a loader can map the file and use the table in place with
+// no parsing and no per-entry allocation (see q_learning_ai.c). The
+// header records the layout the file was written with; files from a
+// build with a different QTable layout are rejected, not misread.
+#ifndef QTABLE_FILE_H
+#define QTABLE_FILE_H
+
+#include <stdio.h>
+#include <string.h>
+#include "qtable.h"
+
+#define QT_FILE_MAGIC    "TTQT"
+#define QT_FILE_VERSION  2   // 2: QTable gained `symmetric`
+#define QT_FILE_EXT      ".qtb"
+
+typedef struct {
+    char magic[4];           // QT_FILE_MAGIC
+    uint32_t version;        // QT_FILE_VERSION
+    uint32_t states;         // BB_STATES
+    uint32_t actions;        // BB_CELLS
+    uint32_t payload_size;   // sizeof(QTable)
+    uint32_t checksum;       // qt_checksum() of the payload
+    uint32_t total_entries;  // copy of the table's count, for quick listing
+    uint32_t sequence;       // trainer checkpoint number, 0 if none
+    uint32_t reserved[8];    // zero; pads the header to 64 bytes
+} QtFileHeader;
+
+// FNV-1a over 32-bit words (the payload size is a multiple of 4)
+static inline uint32_t qt_checksum(const void *data, size_t size)
+{
+    const uint32_t *w = (const uint32_t *)data;
+    uint32_t h = 2166136261u;
+
+    for (size_t i = 0; i < size / 4; i++)
+        h = (h ^ w[i]) * 16777619u;
+    return h;
+}
+
+// Does the name end in QT_FILE_EXT?
+static inline int qt_is_binary_name(const char *path)
+{
+    size_t n = strlen(path), e = strlen(QT_FILE_EXT);
+    return n >= e && strcmp(path + n - e, QT_FILE_EXT) == 0;
+}
+
+// Does the file start with QT_FILE_MAGIC?
+static inline int qt_is_binary_file(const char *path)
+{
+    char magic[4];
+    FILE *fp = fopen(path, "rb");
+    int ok;
+
+    if (!fp)
+        return 0;
+    ok = fread(magic, 1, 4, fp) == 4 && memcmp(magic, QT_FILE_MAGIC, 4) == 0;
+    fclose(fp);
+    return ok;
+}
+
+// NULL if header and payload describe a valid table, else the reason.
+// file_size is the whole file, header included.
+static inline const char *qt_check_file(const QtFileHeader *h, const void *payload, size_t file_size)
+{
+    if (file_size < sizeof(QtFileHeader) || memcmp(h->magic, QT_FILE_MAGIC, 4) != 0)
+        return "not a Q-table file";
+    if (h->version != QT_FILE_VERSION)
+        return "unsupported version";
+    if (h->states != BB_STATES || h->actions != BB_CELLS || h->payload_size != sizeof(QTable))
+        return "table layout does not match this build";
+    if (file_size != sizeof(QtFileHeader) + sizeof(QTable))
+        return "wrong file size";
+    if (qt_checksum(payload, sizeof(QTable)) != h->checksum)
+        return "checksum mismatch";
+    return NULL;
+}
+
+// Returns 1 on success. sequence is stored for the trainer's delta
+// checkpoints (0 when unused).
+static inline int qt_save_binary(const char *path, const QTable *qt, uint32_t sequence)
+{
+    QtFileHeader h;
+    FILE *fp = fopen(path, "wb");
+    int ok;
+
+    if (!fp)
+        return 0;
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, QT_FILE_MAGIC, 4);
+    h.version = QT_FILE_VERSION;
+    h.states = BB_STATES;
+    h.actions = BB_CELLS;
+    h.payload_size = sizeof(QTable);
+    h.checksum = qt_checksum(qt, sizeof(QTable));
+    h.total_entries = (uint32_t)qt->total_entries;
+    h.sequence = sequence;
+
+    ok = fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(qt, sizeof(QTable), 1, fp) == 1;
+    if (fclose(fp) != 0)
+        ok = 0;
+    return ok;
+}
+
+// Copy a binary file into qt (for tools that change the table).
+// sequence (may be NULL) receives the header's checkpoint number.
+// Returns 1 on success; on failure prints the reason and leaves qt empty.
+static inline int qt_read_binary(const char *path, QTable *qt, uint32_t *sequence)
+{
+    QtFileHeader h;
+    FILE *fp = fopen(path, "rb");
+    const char *err = "cannot open file";
+    size_t got = 0;
+
+    qt_init(qt);
+    if (fp)
+    {
+        got = fread(&h, 1, sizeof(h), fp);
+        if (got == sizeof(h))
+            got += fread(qt, 1, sizeof(QTable), fp);
+        if (fgetc(fp) != EOF)
+            got++;   // trailing bytes fail the size check
+        fclose(fp);
+        err = qt_check_file(&h, qt, got);
+    }
+    if (err)
+    {
+        fprintf(stderr, "Error: %s: %s\n", path, err);
+        qt_init(qt);
+        return 0;
+    }
+    if (qt->symmetric)
+        qt_canon_init();   // before the table can be shared between threads
+    if (sequence)
+        *sequence = h.sequence;
+    return 1;
+}
+
+#endif // QTABLE_FILE_H
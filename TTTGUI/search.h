@@ -0,0 +1,207 @@
+// search.h - alpha-beta minimax kernel shared by the GUI and the trainers
+//
+// Searches from the maximizing side's point of view ("me" vs "opp").
+// Children are tried centre, corners, edges, with up to two killer moves
+// per ply first. Root callers that need exact per-move scores call with
+// the full (-SEARCH_INF, SEARCH_INF) window.
+//
+// With ctx->tt set, results are shared through a transposition table
+// (transposition.h). Entries hold scores relative to the node, so one
+// entry serves the position at any depth below any root.
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "bitboard.h"
+#include "transposition.h"
+
+#define SEARCH_INF 1000
+#define SEARCH_MAX_PLY 10
+#define SEARCH_WIN 10
+
+typedef struct {
+    unsigned long nodes;     // positions visited
+    unsigned long cutoffs;   // alpha-beta cutoffs taken
+} SearchStats;
+
+typedef struct {
+    int max_depth;     // 0 = search to the end of the game
+    int depth_bias;    // 1: wins score 10 - depth (prefer quick wins), 0: flat +/-10
+    int root_depth;    // depth the current search_value() call started at
+    TransTable *tt;    // optional, NULL = no table
+    int killers[SEARCH_MAX_PLY][2];
+    TTKey keys[SEARCH_MAX_PLY];   // Zobrist keys along the current line
+    SearchStats stats;
+} SearchContext;
+
+// Centre, corners, edges
+static const int SEARCH_ORDER[9] = {4, 0, 2, 6, 8, 1, 3, 5, 7};
+
+static inline void search_init(SearchContext *ctx, int max_depth, int depth_bias)
+{
+    ctx->max_depth = max_depth;
+    ctx->depth_bias = depth_bias;
+    ctx->root_depth = 0;
+    ctx->tt = NULL;
+    for (int i = 0; i < SEARCH_MAX_PLY; i++)
+    {
+        ctx->killers[i][0] = -1;
+        ctx->killers[i][1] = -1;
+    }
+    ctx->stats.nodes = 0;
+    ctx->stats.cutoffs = 0;
+}
+
+// Fill moves[] with the empty cells in search order; returns the count
+static inline int search_order_moves(const SearchContext *ctx, unsigned empty, int ply, int moves[9])
+{
+    int n = 0;
+
+    for (int k = 0; k < 2; k++)
+    {
+        int km = ctx->killers[ply][k];
+        if (km >= 0 && (empty & (1u << km)))
+        {
+            moves[n++] = km;
+            empty &= ~(1u << km);
+        }
+    }
+    for (int k = 0; k < 9; k++)
+    {
+        if (empty & (1u << SEARCH_ORDER[k]))
+            moves[n++] = SEARCH_ORDER[k];
+    }
+    return n;
+}
+
+static inline void search_store_killer(SearchContext *ctx, int ply, int move)
+{
+    if (ctx->killers[ply][0] != move)
+    {
+        ctx->killers[ply][1] = ctx->killers[ply][0];
+        ctx->killers[ply][0] = move;
+    }
+}
+
+// Score at the given depth <-> score relative to the node itself
+static inline int search_to_tt(int v, int depth, int bias)
+{
+    return v > 0 ? v + depth * bias : (v < 0 ? v - depth * bias : 0);
+}
+
+static inline int search_from_tt(int v, int depth, int bias)
+{
+    return v > 0 ? v - depth * bias : (v < 0 ? v + depth * bias : 0);
+}
+
+// Fail-soft alpha-beta. Returns the score for "me"; depth counts plies
+// from the caller's root and drives both the cap and the depth bias.
+static int search_ab(SearchContext *ctx, uint16_t me, uint16_t opp, int me_to_move,
+                     int depth, int alpha, int beta)
+{
+    unsigned empty;
+    int moves[9];
+    int n, best, value;
+    int ply = depth - ctx->root_depth;
+    int remaining = 0;
+    uint64_t key = 0;
+
+    ctx->stats.nodes++;
+
+    // Terminal states first (win / loss / draw)
+    if (bb_has_win(me))
+        return SEARCH_WIN - depth * ctx->depth_bias;
+    if (bb_has_win(opp))
+        return -SEARCH_WIN + depth * ctx->depth_bias;
+
+    empty = ~(unsigned)(me | opp) & BB_FULL;
+    if (empty == 0)
+        return 0;
+
+    // Depth cap: unresolved positions count as level
+    if (ctx->max_depth > 0 && depth >= ctx->max_depth)
+        return 0;
+
+    if (ctx->tt)
+    {
+        // A cap further away than the end of the game does not matter,
+        // so uncapped and loosely capped searches share entries
+        const TTEntry *e;
+
+        remaining = bb_popcount(empty);
+        if (ctx->max_depth > 0 && ctx->max_depth - depth < remaining)
+            remaining = ctx->max_depth - depth;
+
+        key = tt_key_canonical(&ctx->keys[ply], me_to_move);
+        e = tt_probe(ctx->tt, key, remaining, ctx->depth_bias);
+        if (e)
+        {
+            value = search_from_tt(e->value, depth, ctx->depth_bias);
+            if (e->bound == TT_BOUND_EXACT)
+                return value;
+            if (e->bound == TT_BOUND_LOWER && value > alpha)
+                alpha = value;
+            else if (e->bound == TT_BOUND_UPPER && value < beta)
+                beta = value;
+            if (alpha >= beta)
+                return value;
+        }
+    }
+
+    int alpha0 = alpha;
+    int beta0 = beta;
+
+    n = search_order_moves(ctx, empty, ply, moves);
+    best = me_to_move ? -SEARCH_INF : SEARCH_INF;
+
+    for (int k = 0; k < n; k++)
+    {
+        uint16_t bit = (uint16_t)(1u << moves[k]);
+
+        if (ctx->tt)
+            tt_key_play(&ctx->keys[ply], &ctx->keys[ply + 1], moves[k], me_to_move ? 0 : 1);
+
+        if (me_to_move)
+        {
+            value = search_ab(ctx, me | bit, opp, 0, depth + 1, alpha, beta);
+            if (value > best)
+                best = value;
+            if (best > alpha)
+                alpha = best;
+        }
+        else
+        {
+            value = search_ab(ctx, me, opp | bit, 1, depth + 1, alpha, beta);
+            if (value < best)
+                best = value;
+            if (best < beta)
+                beta = best;
+        }
+
+        if (alpha >= beta)
+        {
+            ctx->stats.cutoffs++;
+            search_store_killer(ctx, ply, moves[k]);
+            break;
+        }
+    }
+
+    if (ctx->tt)
+    {
+        int bound = (best <= alpha0) ? TT_BOUND_UPPER :
+                    (best >= beta0)  ? TT_BOUND_LOWER : TT_BOUND_EXACT;
+        tt_store(ctx->tt, key, remaining, ctx->depth_bias,
+                 search_to_tt(best, depth, ctx->depth_bias), bound);
+    }
+    return best;
+}
+
+// Exact score of a position (full window)
+static inline int search_value(SearchContext *ctx, uint16_t me, uint16_t opp, int me_to_move, int depth)
+{
+    ctx->root_depth = depth;
+    if (ctx->tt)
+        tt_key_init(&ctx->keys[0], me, opp);
+    return search_ab(ctx, me, opp, me_to_move, depth, -SEARCH_INF, SEARCH_INF);
+}
+
+#endif // SEARCH_H
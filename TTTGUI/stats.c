@@ -27,7 +27,8 @@ static double get_memory_kb(void)
 
 
 // Record AI performance data to log file
-void stats_log_ai_move(int mode, int level, int move_no, double ms, int depth)
+void stats_log_ai_move(int mode, int level, int move_no, double ms, int depth,
+                       unsigned long nodes, unsigned long cutoffs)
 {
     FILE *f = fopen(AI_TIME_FILE, "a");
     if (!f) return;
@@ -45,13 +46,15 @@ void stats_log_ai_move(int mode, int level, int move_no, double ms, int depth)
 
     double mem_kb = get_memory_kb();
 
-    fprintf(f, "%s, mode=%s, level=%s, move=%d, ms=%.3f, depth=%d, mem=%.2fKB\n",
+    fprintf(f, "%s, mode=%s, level=%s, move=%d, ms=%.3f, depth=%d, nodes=%lu, cutoffs=%lu, mem=%.2fKB\n",
             ts,
             (mode == 0 ? "PVP" : "PVAI"),
             levelmode,
             move_no,
             ms,
             depth,
+            nodes,
+            cutoffs,
             mem_kb);
 
     fclose(f);
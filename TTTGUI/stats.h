@@ -19,6 +19,8 @@ void stats_get_counts_mode(StatsMode mode, int level,
 void stats_reset_pvp(void);
 
 // stats.h
-void stats_log_ai_move(int mode, int level, int move_no, double ms, int depth);
+// nodes/cutoffs: minimax search work for this move (0 for table lookups)
+void stats_log_ai_move(int mode, int level, int move_no, double ms, int depth,
+                       unsigned long nodes, unsigned long cutoffs);
 
 #endif // STATS_H
@@ -0,0 +1,67 @@
+// symmetry.h - the 8 rotations/reflections (D4) of the 3x3 board
+//
+// SYM_PERM[s][i] is where cell i lands under symmetry s. Used to fold
+// boards that are rotations or reflections of each other onto one
+// canonical board, and to map moves back to the original orientation.
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "bitboard.h"
+
+#define SYM_COUNT 8
+
+static const uint8_t SYM_PERM[SYM_COUNT][BB_CELLS] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8},   // identity
+    {2, 5, 8, 1, 4, 7, 0, 3, 6},   // rotate 90 clockwise
+    {8, 7, 6, 5, 4, 3, 2, 1, 0},   // rotate 180
+    {6, 3, 0, 7, 4, 1, 8, 5, 2},   // rotate 270 clockwise
+    {2, 1, 0, 5, 4, 3, 8, 7, 6},   // mirror left-right
+    {6, 7, 8, 3, 4, 5, 0, 1, 2},   // mirror top-bottom
+    {0, 3, 6, 1, 4, 7, 2, 5, 8},   // main diagonal
+    {8, 5, 2, 7, 4, 1, 6, 3, 0}    // anti-diagonal
+};
+
+// Symmetry that undoes s
+static const uint8_t SYM_INVERSE[SYM_COUNT] = {0, 3, 2, 1, 4, 5, 6, 7};
+
+static inline uint16_t sym_apply_mask(uint16_t m, int s)
+{
+    uint16_t out = 0;
+    for (; m; m &= (uint16_t)(m - 1))
+        out |= (uint16_t)(1u << SYM_PERM[s][bb_first(m)]);
+    return out;
+}
+
+static inline Bitboard sym_apply(Bitboard bb, int s)
+{
+    Bitboard out;
+    out.x = sym_apply_mask(bb.x, s);
+    out.o = sym_apply_mask(bb.o, s);
+    return out;
+}
+
+// Canonical board: the transform with the smallest base-3 index.
+// *sym_out (optional) receives the symmetry that maps bb onto it.
+static inline Bitboard sym_canonical(Bitboard bb, int *sym_out)
+{
+    Bitboard best = bb;
+    int best_idx = bb_index(bb);
+    int best_s = 0;
+
+    for (int s = 1; s < SYM_COUNT; s++)
+    {
+        Bitboard t = sym_apply(bb, s);
+        int idx = bb_index(t);
+        if (idx < best_idx)
+        {
+            best = t;
+            best_idx = idx;
+            best_s = s;
+        }
+    }
+    if (sym_out)
+        *sym_out = best_s;
+    return best;
+}
+
+#endif // SYMMETRY_H
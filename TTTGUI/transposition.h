@@ -0,0 +1,196 @@
+// transposition.h - symmetry-folded transposition table for search.h
+//
+// Positions are keyed by Zobrist hashing. Each key is kept under all 8
+// board symmetries at once (updated incrementally per move), and the
+// smallest of the 8 is the canonical key, so a board and its rotations
+// and reflections share one entry.
+//
+// The table is a fixed number of 2-slot buckets: slot 0 keeps the entry
+// searched deepest, slot 1 always takes the newest. A table is not
+// thread-safe; give each thread its own via tt_create().
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stdlib.h>
+#include "symmetry.h"
+
+#ifndef TT_DEFAULT_BITS
+#define TT_DEFAULT_BITS 13   // 8192 buckets, 16384 entries (256 KB)
+#endif
+
+#define TT_BOUND_EXACT 0
+#define TT_BOUND_LOWER 1     // true score >= value
+#define TT_BOUND_UPPER 2     // true score <= value
+
+// Zobrist key of one position under each symmetry
+typedef struct {
+    uint64_t s[SYM_COUNT];
+} TTKey;
+
+typedef struct {
+    uint64_t key;        // canonical key (side to move folded in)
+    int8_t   value;      // score relative to this node (see search.h)
+    uint8_t  remaining;  // plies the search could still look ahead
+    uint8_t  bound;      // TT_BOUND_*
+    uint8_t  bias;       // SearchContext depth_bias the score was made with
+    uint8_t  used;
+} TTEntry;
+
+typedef struct {
+    TTEntry *slots;      // 2 per bucket
+    uint32_t mask;       // bucket count - 1
+    unsigned long probes;
+    unsigned long hits;
+    unsigned long stores;
+} TransTable;
+
+// tt_zobrist[s][cell][side]: random key of cell under symmetry s,
+// side 0 = the searching player, 1 = the opponent
+static uint64_t tt_zobrist[SYM_COUNT][BB_CELLS][2];
+static uint64_t tt_zobrist_side;
+static int tt_zobrist_ready = 0;
+
+// Fixed-seed xorshift64* so keys are the same on every run
+static void tt_zobrist_init(void)
+{
+    uint64_t base[BB_CELLS][2];
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+
+    if (tt_zobrist_ready)
+        return;
+
+    for (int i = 0; i < BB_CELLS; i++)
+    {
+        for (int p = 0; p < 2; p++)
+        {
+            x ^= x >> 12;
+            x ^= x << 25;
+            x ^= x >> 27;
+            base[i][p] = x * 0x2545F4914F6CDD1DULL;
+        }
+    }
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    tt_zobrist_side = x * 0x2545F4914F6CDD1DULL;
+
+    // A piece on cell i under symmetry s hashes like a piece on its image
+    for (int s = 0; s < SYM_COUNT; s++)
+        for (int i = 0; i < BB_CELLS; i++)
+            for (int p = 0; p < 2; p++)
+                tt_zobrist[s][i][p] = base[SYM_PERM[s][i]][p];
+
+    tt_zobrist_ready = 1;
+}
+
+static inline void tt_key_init(TTKey *k, uint16_t me, uint16_t opp)
+{
+    tt_zobrist_init();
+    for (int s = 0; s < SYM_COUNT; s++)
+    {
+        uint64_t h = 0;
+        for (unsigned m = me; m; m &= m - 1)
+            h ^= tt_zobrist[s][bb_first(m)][0];
+        for (unsigned m = opp; m; m &= m - 1)
+            h ^= tt_zobrist[s][bb_first(m)][1];
+        k->s[s] = h;
+    }
+}
+
+// Key after "side" (0 = me, 1 = opponent) plays on cell
+static inline void tt_key_play(const TTKey *k, TTKey *out, int cell, int side)
+{
+    for (int s = 0; s < SYM_COUNT; s++)
+        out->s[s] = k->s[s] ^ tt_zobrist[s][cell][side];
+}
+
+static inline uint64_t tt_key_canonical(const TTKey *k, int me_to_move)
+{
+    uint64_t best = k->s[0];
+    for (int s = 1; s < SYM_COUNT; s++)
+    {
+        if (k->s[s] < best)
+            best = k->s[s];
+    }
+    return me_to_move ? best ^ tt_zobrist_side : best;
+}
+
+// bits: log2 of the bucket count. Returns NULL if out of memory.
+static TransTable *tt_create(int bits)
+{
+    TransTable *tt = (TransTable *)malloc(sizeof(TransTable));
+    if (!tt)
+        return NULL;
+
+    tt->mask = (1u << bits) - 1;
+    tt->slots = (TTEntry *)calloc((size_t)2 << bits, sizeof(TTEntry));
+    if (!tt->slots)
+    {
+        free(tt);
+        return NULL;
+    }
+    tt->probes = tt->hits = tt->stores = 0;
+    tt_zobrist_init();
+    return tt;
+}
+
+static inline void tt_free(TransTable *tt)
+{
+    if (!tt)
+        return;
+    free(tt->slots);
+    free(tt);
+}
+
+static inline void tt_clear(TransTable *tt)
+{
+    for (size_t i = 0; i < (size_t)2 * (tt->mask + 1); i++)
+        tt->slots[i].used = 0;
+    tt->probes = tt->hits = tt->stores = 0;
+}
+
+// One table per process (per program, as the tools are single-file),
+// created on first use so every search in a run shares solved positions
+static TransTable *tt_shared(void)
+{
+    static TransTable *shared = NULL;
+    if (!shared)
+        shared = tt_create(TT_DEFAULT_BITS);
+    return shared;
+}
+
+static inline const TTEntry *tt_probe(TransTable *tt, uint64_t key, int remaining, int bias)
+{
+    TTEntry *e = &tt->slots[(size_t)(key & tt->mask) * 2];
+
+    tt->probes++;
+    for (int k = 0; k < 2; k++, e++)
+    {
+        if (e->used && e->key == key && e->remaining == remaining && e->bias == bias)
+        {
+            tt->hits++;
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static inline void tt_store(TransTable *tt, uint64_t key, int remaining, int bias, int value, int bound)
+{
+    TTEntry *e = &tt->slots[(size_t)(key & tt->mask) * 2];
+
+    // Slot 0 unless it holds a deeper, different result
+    if (e->used && e->remaining > remaining &&
+        !(e->key == key && e->bias == bias))
+        e++;
+
+    e->key = key;
+    e->value = (int8_t)value;
+    e->remaining = (uint8_t)remaining;
+    e->bound = (uint8_t)bound;
+    e->bias = (uint8_t)bias;
+    e->used = 1;
+    tt->stores++;
+}
+
+#endif // TRANSPOSITION_H
@@ -4,6 +4,11 @@
 #include <math.h>
 #include <time.h>
 
+#include "../TTTGUI/perfect_table.h"
+#include "../TTTGUI/search.h"
+#include "../TTTGUI/qtable.h"
+#include "../TTTGUI/nb_model.h"
+
 // =====================================================
 // MODEL CONFIGURATION (matching TTTGUI framework)
 // =====================================================
@@ -18,28 +23,8 @@ typedef enum {
 // =====================================================
 // NAIVE BAYES STRUCTURES
 // =====================================================
-#define MAX_FEATURES_NB 9
-#define MAX_STATES 10
-#define MAX_LABELS 10
-#define MAX_FEATURE_LENGTH 32
-
-typedef struct {
-    char state[MAX_FEATURE_LENGTH];
-    char label[MAX_FEATURE_LENGTH];
-    double probability;
-} FeatureProbability;
-
-typedef struct {
-    char label[MAX_FEATURE_LENGTH];
-    double probability;
-} LabelProbability;
-
-typedef struct {
-    FeatureProbability feature_probs[MAX_FEATURES_NB][MAX_STATES * MAX_LABELS];
-    int feature_count[MAX_FEATURES_NB];
-    LabelProbability label_probs[MAX_LABELS];
-    int label_count;
-} NaiveBayesModel;
+// The compact model shared with the GUI and the trainer (nb_model.h)
+typedef NbModel NaiveBayesModel;
 
 // =====================================================
 // LINEAR REGRESSION STRUCTURES
@@ -53,20 +38,8 @@ typedef struct {
 // =====================================================
 // Q-LEARNING STRUCTURES
 // =====================================================
-#define Q_TABLE_SIZE 20000
-
-typedef struct QEntry {
-    char board[9];
-    int action;
-    double q_value;
-    int visits;
-    struct QEntry *next;
-} QEntry;
-
-typedef struct {
-    QEntry *table[Q_TABLE_SIZE];
-    int total_entries;
-} QLearningModel;
+// The direct-indexed table shared with the GUI (~1.4 MB: keep it static)
+typedef QTable QLearningModel;
 
 // =====================================================
 // CONFUSION MATRIX
@@ -136,169 +109,52 @@ int eval_board(const char b[9]) {
     return 0;
 }
 
+// Full-depth minimax scored for O, via the shared alpha-beta kernel.
+// The transposition table persists for the whole run, so each position
+// (up to symmetry) is solved once however many models are evaluated.
 int minimax(char b[9], int isMax, int depth) {
-    int score = eval_board(b);
-    
-    if (score == 10) return score - depth;
-    if (score == -10) return score + depth;
-    if (!has_space(b)) return 0;
-    
-    if (isMax) {
-        int best = -1000;
-        for (int i = 0; i < 9; i++) {
-            if (b[i] != 'X' && b[i] != 'O') {
-                char save = b[i];
-                b[i] = 'O';
-                int value = minimax(b, 0, depth + 1);
-                b[i] = save;
-                if (value > best) best = value;
-            }
-        }
-        return best;
-    } else {
-        int best = 1000;
-        for (int i = 0; i < 9; i++) {
-            if (b[i] != 'X' && b[i] != 'O') {
-                char save = b[i];
-                b[i] = 'X';
-                int value = minimax(b, 1, depth + 1);
-                b[i] = save;
-                if (value < best) best = value;
-            }
-        }
-        return best;
-    }
+    Bitboard bb = bb_from_chars(b);
+    SearchContext ctx;
+    
+    search_init(&ctx, 0, 1);
+    ctx.tt = tt_shared();
+    return search_value(&ctx, bb.o, bb.x, isMax, depth);
 }
 
+// Ground-truth move from the precomputed perfect-play table
 int minimax_best_move(char b[9]) {
-    int best_move = -1;
-    int best_val = -1000;
-    
-    for (int i = 0; i < 9; i++) {
-        if (b[i] != 'X' && b[i] != 'O') {
-            char save = b[i];
-            b[i] = 'O';
-            int val = minimax(b, 0, 0);
-            b[i] = save;
-            
-            if (val > best_val) {
-                best_val = val;
-                best_move = i;
-            }
-        }
-    }
-    
-    return best_move;
+    return pt_best_move_o(bb_from_chars(b));
 }
 
 // Classify position as Win/Loss/Draw (for confusion matrix)
+// Uses the game-theoretic value of the position with O to move
 int minimax_classify_position(char b[9]) {
-    // Make optimal move and check eventual outcome
-    char temp[9];
-    memcpy(temp, b, 9);
-    
-    // Simulate optimal play to completion
-    char player = 'O';  // O's turn (AI)
-    
-    while (has_space(temp) && eval_board(temp) == 0) {
-        int move = (player == 'O') ? minimax_best_move(temp) : minimax_best_move(temp);
-        if (move == -1) break;
-        
-        temp[move] = player;
-        player = (player == 'O') ? 'X' : 'O';
-    }
+    int value = pt_value(bb_from_chars(b));
     
-    // Classify outcome
-    if (winBy(temp, 'O')) return 0;      // Win
-    if (winBy(temp, 'X')) return 1;      // Loss
-    return 2;                             // Draw
+    if (value > 0) return 0;      // Win
+    if (value < 0) return 1;      // Loss
+    return 2;                     // Draw
 }
 
 // =====================================================
 // MODEL LOADING (Naive Bayes)
 // =====================================================
 int nb_load_model(const char *filename, NaiveBayesModel *model) {
-    FILE *fp = fopen(filename, "r");
-    if (!fp) return 0;
-    
-    char line[256];
-    model->label_count = 0;
-    for (int i = 0; i < MAX_FEATURES_NB; i++) {
-        model->feature_count[i] = 0;
-    }
-    
-    while (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, "Total labels:") != NULL) {
-            sscanf(line, "Total labels: %d", &model->label_count);
-            fgets(line, sizeof(line), fp);
-            break;
-        }
-    }
-    
-    for (int i = 0; i < model->label_count; i++) {
-        if (fgets(line, sizeof(line), fp)) {
-            sscanf(line, "Label: %s P(Label) = %lf", 
-                   model->label_probs[i].label, 
-                   &model->label_probs[i].probability);
-        }
-    }
-    
-    int current_feature = -1;
-    while (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, "Feature") != NULL && strstr(line, ":") != NULL) {
-            int count;
-            sscanf(line, "Feature %d: (%d unique", &current_feature, &count);
-            model->feature_count[current_feature] = 0;
-        } else if (strstr(line, "State=") != NULL && current_feature >= 0) {
-            int idx = model->feature_count[current_feature];
-            sscanf(line, "  State=%s | Label=%s | P(State|Label) = %lf",
-                   model->feature_probs[current_feature][idx].state,
-                   model->feature_probs[current_feature][idx].label,
-                   &model->feature_probs[current_feature][idx].probability);
-            model->feature_count[current_feature]++;
-        }
-    }
-    
-    fclose(fp);
-    return 1;
+    return nb_load(filename, model);
 }
 
-void board_to_features(const char board[9], char features[MAX_FEATURES_NB][MAX_FEATURE_LENGTH]) {
+void board_to_cells(const char board[9], unsigned char cells[NB_CELLS]) {
     for (int i = 0; i < 9; i++) {
-        if (board[i] == 'X') strcpy(features[i], "x");
-        else if (board[i] == 'O') strcpy(features[i], "o");
-        else strcpy(features[i], "b");
+        cells[i] = (unsigned char)(board[i] == 'X' ? NB_CELL_X : board[i] == 'O' ? NB_CELL_O : NB_CELL_B);
     }
 }
 
-void nb_predict(const NaiveBayesModel *model, char features[MAX_FEATURES_NB][MAX_FEATURE_LENGTH], 
-                char *best_label, double *best_prob) {
-    double max_prob = -1.0;
-    strcpy(best_label, "draw");
-    
-    for (int i = 0; i < model->label_count; i++) {
-        double prob = model->label_probs[i].probability;
-        
-        for (int j = 0; j < MAX_FEATURES_NB; j++) {
-            int found = 0;
-            for (int k = 0; k < model->feature_count[j]; k++) {
-                if (strcmp(model->feature_probs[j][k].state, features[j]) == 0 &&
-                    strcmp(model->feature_probs[j][k].label, model->label_probs[i].label) == 0) {
-                    prob *= model->feature_probs[j][k].probability;
-                    found = 1;
-                    break;
-                }
-            }
-            if (!found) prob *= 0.001;
-        }
-        
-        if (prob > max_prob) {
-            max_prob = prob;
-            strcpy(best_label, model->label_probs[i].label);
-        }
-    }
-    
-    *best_prob = max_prob;
+// Predicted label ("draw" for a model without labels); P(state|label)
+// is 0.001 for pairs the model lacks
+const char *nb_predict(const NaiveBayesModel *model, const unsigned char cells[NB_CELLS],
+                       double *best_prob) {
+    int label = nb_predict_label(model, cells, 0.001, best_prob);
+    return label >= 0 ? model->labels[label] : "draw";
 }
 
 int nb_find_best_move(const NaiveBayesModel *model, char board[9]) {
@@ -322,12 +178,11 @@ int nb_find_best_move(const NaiveBayesModel *model, char board[9]) {
         memcpy(temp_board, board, 9);
         temp_board[move] = 'O';
         
-        char features[MAX_FEATURES_NB][MAX_FEATURE_LENGTH];
-        board_to_features(temp_board, features);
+        unsigned char cells[NB_CELLS];
+        board_to_cells(temp_board, cells);
         
-        char predicted_label[MAX_FEATURE_LENGTH];
         double prob;
-        nb_predict(model, features, predicted_label, &prob);
+        const char *predicted_label = nb_predict(model, cells, &prob);
         
         double score = 0.0;
         if (strcmp(predicted_label, "win") == 0) score = prob;
@@ -344,12 +199,11 @@ int nb_find_best_move(const NaiveBayesModel *model, char board[9]) {
 }
 
 int nb_classify(const NaiveBayesModel *model, char board[9]) {
-    char features[MAX_FEATURES_NB][MAX_FEATURE_LENGTH];
-    board_to_features(board, features);
+    unsigned char cells[NB_CELLS];
+    board_to_cells(board, cells);
     
-    char label[MAX_FEATURE_LENGTH];
     double prob;
-    nb_predict(model, features, label, &prob);
+    const char *label = nb_predict(model, cells, &prob);
     
     if (strcmp(label, "win") == 0) return 0;
     if (strcmp(label, "lose") == 0) return 1;  // Fixed: model uses "lose" not "loss"
@@ -450,58 +304,23 @@ int lr_classify(const LinearRegressionModel *model, char board[9]) {
 // =====================================================
 // MODEL LOADING (Q-Learning)
 // =====================================================
-void init_qtable(QLearningModel *model) {
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        model->table[i] = NULL;
-    }
-    model->total_entries = 0;
-}
-
-unsigned long hash_board(char board[9]) {
-    unsigned long hash = 5381;
-    for (int i = 0; i < 9; i++) {
-        hash = ((hash << 5) + hash) + board[i];
-    }
-    return hash % Q_TABLE_SIZE;
-}
-
-double get_q_value(const QLearningModel *model, char board[9], int action) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = model->table[hash];
-    
-    while (entry != NULL) {
-        if (entry->action == action && 
-            memcmp(entry->board, board, 9) == 0) {
-            return entry->q_value;
-        }
-        entry = entry->next;
-    }
-    
-    return 0.0;
-}
-
-void add_q_entry(QLearningModel *model, char board[9], int action, double q_value, int visits) {
-    unsigned long hash = hash_board(board);
-    
-    QEntry *new_entry = (QEntry *)malloc(sizeof(QEntry));
-    memcpy(new_entry->board, board, 9);
-    new_entry->action = action;
-    new_entry->q_value = q_value;
-    new_entry->visits = visits;
-    new_entry->next = model->table[hash];
-    model->table[hash] = new_entry;
-    model->total_entries++;
+// Q(board, action) for the board's row index (qt_state)
+double get_q_value(const QLearningModel *model, int state, int action) {
+    return qt_value(model, state, action);
 }
 
 int ql_load_model(const char *filename, QLearningModel *model) {
     FILE *fp = fopen(filename, "r");
     if (!fp) return 0;
     
-    init_qtable(model);
+    qt_init(model);
     
     char line[256];
     while (fgets(line, sizeof(line), fp)) {
         if (line[0] != '#') break;
+        if (strncmp(line, QT_SYMMETRIC_TAG, strlen(QT_SYMMETRIC_TAG)) == 0) {
+            qt_set_symmetric(model, 1);
+        }
     }
     
     do {
@@ -525,7 +344,9 @@ int ql_load_model(const char *filename, QLearningModel *model) {
                 token = strtok(NULL, ",");
                 if (token != NULL) {
                     visits = atoi(token);
-                    add_q_entry(model, board, action, q_value, visits);
+                    if (action >= 0 && action < 9) {
+                        qt_set(model, qt_state(board), action, (float)q_value, visits);
+                    }
                 }
             }
         }
@@ -554,12 +375,13 @@ int ql_find_best_move(const QLearningModel *model, char board[9]) {
         else q_board[i] = 'b';
     }
     
+    int state = qt_state(q_board);
     int best_move = empty_cells[0];
     double best_q = -1000.0;
     
     for (int i = 0; i < empty_count; i++) {
         int move = empty_cells[i];
-        double q_val = get_q_value(model, q_board, move);
+        double q_val = get_q_value(model, state, move);
         
         if (q_val > best_q) {
             best_q = q_val;
@@ -579,10 +401,11 @@ int ql_classify(const QLearningModel *model, char board[9]) {
         else q_board[i] = 'b';
     }
     
+    int state = qt_state(q_board);
     double max_q = -1000.0;
     for (int i = 0; i < 9; i++) {
         if (board[i] != 'X' && board[i] != 'O') {
-            double q = get_q_value(model, q_board, i);
+            double q = get_q_value(model, state, i);
             if (q > max_q) max_q = q;
         }
     }
@@ -855,6 +678,9 @@ int main() {
     printf("Confusion Matrix + Move Quality Analysis\n");
     printf("========================================\n\n");
     
+    // Solve ground-truth table once for the whole run
+    pt_init();
+    
     // Generate test positions
     printf("Generating test positions...\n");
     char test_positions[500][9];
@@ -903,7 +729,7 @@ int main() {
     }
     
     // Load and evaluate Q-Learning (Non-Terminal)
-    QLearningModel ql_model_nt;
+    static QLearningModel ql_model_nt;
     if (ql_load_model("../models/q learning/q_learning_non_terminal.txt", &ql_model_nt)) {
         evaluate_model_comprehensive(&ql_model_nt, AI_MODEL_Q_LEARNING,
                                      "Q-Learning (Non-Terminal)",
@@ -913,7 +739,7 @@ int main() {
     }
     
     // Load and evaluate Q-Learning (Combined/Dataset)
-    QLearningModel ql_model_comb;
+    static QLearningModel ql_model_comb;
     if (ql_load_model("../models/q learning/q_learning_dataset.txt", &ql_model_comb)) {
         evaluate_model_comprehensive(&ql_model_comb, AI_MODEL_Q_LEARNING,
                                      "Q-Learning (Dataset-Init)",
@@ -937,6 +763,10 @@ int main() {
     printf("\n========================================\n");
     printf("EVALUATION COMPLETE\n");
     printf("========================================\n");
+    if (tt_shared()) {
+        printf("Minimax transposition table: %lu probes, %lu hits, %lu stores\n",
+               tt_shared()->probes, tt_shared()->hits, tt_shared()->stores);
+    }
     printf("\nKEY METRICS EXPLAINED:\n");
     printf("- Confusion Matrix: Shows how well model predicts Win/Loss/Draw\n");
     printf("- Move Agreement: How often model picks same move as Minimax\n");
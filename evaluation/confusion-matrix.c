@@ -4,12 +4,16 @@
 #include <math.h>
 #include <stdbool.h>
 
+#include "../TTTGUI/qtable.h"
+#include "../TTTGUI/dataset_file.h"
+
 #define MAX_SAMPLES 10000
 #define FEATURE_COUNT 9
 
 typedef enum {
     FORMAT_CHARACTER,
-    FORMAT_MATRIX
+    FORMAT_MATRIX,
+    FORMAT_PACKED        // binary .tds, see dataset_file.h
 } DatasetFormat;
 
 typedef struct {
@@ -92,19 +96,8 @@ typedef struct {
 // Q-LEARNING MODEL
 // ============================
 
-#define Q_TABLE_SIZE 20000
-
-typedef struct QEntry {
-    char board[9];
-    int action;
-    double q_value;
-    struct QEntry *next;
-} QEntry;
-
-typedef struct {
-    QEntry *table[Q_TABLE_SIZE];
-    int total_entries;
-} QLearningModel;
+// The direct-indexed table shared with the GUI (~1.4 MB: keep it static)
+typedef QTable QLearningModel;
 
 // ============================
 // DATASET FUNCTIONS
@@ -162,7 +155,30 @@ DatasetFormat detect_format(const char *filename) {
     return FORMAT_MATRIX;
 }
 
+// Packed binary dataset: one read, then expand records into samples
+int load_packed_dataset(const char *filename, Dataset *ds) {
+    int count;
+    DsRecord *records = ds_read(filename, &count);
+    
+    ds->format = FORMAT_PACKED;
+    ds->count = 0;
+    if (!records) return 0;
+    
+    for (int i = 0; i < count && ds->count < ds->capacity; i++) {
+        Sample *s = &ds->data[ds->count++];
+        ds_record_features(&records[i], s->features);
+        s->label = ds_label_value(records[i].label);
+    }
+    
+    free(records);
+    return ds->count;
+}
+
 int load_dataset(const char *filename, Dataset *ds) {
+    if (ds_is_binary_file(filename)) {
+        return load_packed_dataset(filename, ds);
+    }
+    
     FILE *fp = fopen(filename, "r");
     if (!fp) {
         printf("Error: Cannot open dataset file: %s\n", filename);
@@ -399,36 +415,18 @@ int predict_naive_bayes(const NaiveBayesModel *model, const double features[]) {
 // Q-LEARNING FUNCTIONS
 // ============================
 
-unsigned long hash_board(const char board[9]) {
-    unsigned long hash = 5381;
-    for (int i = 0; i < 9; i++) {
-        hash = ((hash << 5) + hash) + board[i];
-    }
-    return hash % Q_TABLE_SIZE;
-}
-
-void add_q_entry(QLearningModel *model, char board[9], int action, double q_value) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = (QEntry*)malloc(sizeof(QEntry));
-    memcpy(entry->board, board, 9);
-    entry->action = action;
-    entry->q_value = q_value;
-    entry->next = model->table[hash];
-    model->table[hash] = entry;
-    model->total_entries++;
-}
-
 bool load_q_learning(const char *filename, QLearningModel *model) {
     FILE *fp = fopen(filename, "r");
     if (!fp) return false;
     
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        model->table[i] = NULL;
-    }
-    model->total_entries = 0;
+    qt_init(model);
     
     char line[256];
     while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, QT_SYMMETRIC_TAG, strlen(QT_SYMMETRIC_TAG)) == 0) {
+            qt_set_symmetric(model, 1);
+            continue;
+        }
         if (line[0] == '#' || line[0] == '\n') continue;
         
         char board[9];
@@ -446,7 +444,9 @@ bool load_q_learning(const char *filename, QLearningModel *model) {
             token = strtok(NULL, ",");
             if (token) {
                 q_value = atof(token);
-                add_q_entry(model, board, action, q_value);
+                if (action >= 0 && action < 9) {
+                    qt_set(model, qt_state(board), action, (float)q_value, 1);
+                }
             }
         }
     }
@@ -455,17 +455,9 @@ bool load_q_learning(const char *filename, QLearningModel *model) {
     return model->total_entries > 0;
 }
 
-double get_q_value(const QLearningModel *model, const char board[9], int action) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = model->table[hash];
-    
-    while (entry) {
-        if (entry->action == action && memcmp(entry->board, board, 9) == 0) {
-            return entry->q_value;
-        }
-        entry = entry->next;
-    }
-    return 0.0;
+// Q(board, action) for the board's row index (qt_state)
+double get_q_value(const QLearningModel *model, int state, int action) {
+    return qt_value(model, state, action);
 }
 
 char decode_feature(double val) {
@@ -482,12 +474,13 @@ int predict_q_learning(const QLearningModel *model, const double features[]) {
     }
     
     // Find best Q-value across all possible actions
+    int state = qt_state(board);
     double best_q = -999999.0;
     int best_action = -1;
     
     for (int action = 0; action < 9; action++) {
         if (board[action] == 'b') {  // Valid move
-            double q = get_q_value(model, board, action);
+            double q = get_q_value(model, state, action);
             if (best_action == -1 || q > best_q) {
                 best_q = q;
                 best_action = action;
@@ -500,14 +493,8 @@ int predict_q_learning(const QLearningModel *model, const double features[]) {
 }
 
 void free_q_learning(QLearningModel *model) {
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        QEntry *entry = model->table[i];
-        while (entry) {
-            QEntry *next = entry->next;
-            free(entry);
-            entry = next;
-        }
-    }
+    // Values are stored inline; nothing to free
+    qt_init(model);
 }
 
 // ============================
@@ -904,7 +891,7 @@ int main(int argc, char *argv[]) {
     // Load model
     LinearRegressionModel lr_model;
     NaiveBayesModel nb_model;
-    QLearningModel ql_model;
+    static QLearningModel ql_model;
     
     bool loaded = false;
     const char *model_name = "";
@@ -942,7 +929,8 @@ int main(int argc, char *argv[]) {
     }
     
     printf("✓ Dataset format: %s\n", 
-           train_ds->format == FORMAT_CHARACTER ? "Character (x,o,b)" : "Matrix (numerical)");
+           train_ds->format == FORMAT_CHARACTER ? "Character (x,o,b)" :
+           train_ds->format == FORMAT_PACKED ? "Packed binary (.tds)" : "Matrix (numerical)");
     printf("✓ Training samples: %d\n", train_count);
     printf("✓ Testing samples:  %d\n", test_count);
     
@@ -4,13 +4,16 @@
 #include <math.h>
 #include <stdbool.h>
 
+#include "../TTTGUI/qtable.h"
+#include "../TTTGUI/dataset_file.h"
+
 #define MAX_SAMPLES 10000
 #define FEATURE_COUNT 9
-#define Q_TABLE_SIZE 10007
 
 typedef enum {
     FORMAT_CHARACTER,
-    FORMAT_MATRIX
+    FORMAT_MATRIX,
+    FORMAT_PACKED        // binary .tds, see dataset_file.h
 } DatasetFormat;
 
 typedef struct {
@@ -58,17 +61,8 @@ typedef struct {
 // Q-LEARNING MODEL
 // ============================
 
-typedef struct QEntry {
-    char board[9];
-    int action;
-    double q_value;
-    struct QEntry *next;
-} QEntry;
-
-typedef struct {
-    QEntry **table;
-    int total_entries;
-} QLearningModel;
+// The direct-indexed table shared with the GUI (~1.4 MB: keep it static)
+typedef QTable QLearningModel;
 
 // ============================
 // DATASET FUNCTIONS
@@ -107,7 +101,33 @@ int encode_char_label(const char *label) {
     return 0;  // draw
 }
 
+// Packed binary dataset: one read, then expand records into samples
+Dataset* load_packed_dataset(const char *filename) {
+    int count;
+    DsRecord *records = ds_read(filename, &count);
+    if (!records) return NULL;
+    
+    Dataset *dataset = (Dataset*)malloc(sizeof(Dataset));
+    dataset->capacity = MAX_SAMPLES;
+    dataset->data = (Sample*)malloc(sizeof(Sample) * dataset->capacity);
+    dataset->count = 0;
+    dataset->format = FORMAT_PACKED;
+    
+    for (int i = 0; i < count && dataset->count < dataset->capacity; i++) {
+        Sample *sample = &dataset->data[dataset->count++];
+        ds_record_features(&records[i], sample->features);
+        sample->label = ds_label_value(records[i].label);
+    }
+    
+    free(records);
+    return dataset;
+}
+
 Dataset* load_dataset(const char *filename) {
+    if (ds_is_binary_file(filename)) {
+        return load_packed_dataset(filename);
+    }
+    
     FILE *fp = fopen(filename, "r");
     if (!fp) {
         printf("Error: Cannot open dataset file: %s\n", filename);
@@ -275,34 +295,18 @@ int predict_naive_bayes(const NaiveBayesModel *model, const double features[]) {
 // Q-LEARNING FUNCTIONS
 // ============================
 
-unsigned long hash_board(const char board[9]) {
-    unsigned long hash = 5381;
-    for (int i = 0; i < 9; i++) {
-        hash = ((hash << 5) + hash) + board[i];
-    }
-    return hash % Q_TABLE_SIZE;
-}
-
-void add_q_entry(QLearningModel *model, char board[9], int action, double q_value) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = (QEntry*)malloc(sizeof(QEntry));
-    memcpy(entry->board, board, 9);
-    entry->action = action;
-    entry->q_value = q_value;
-    entry->next = model->table[hash];
-    model->table[hash] = entry;
-    model->total_entries++;
-}
-
 bool load_q_learning(const char *filename, QLearningModel *model) {
     FILE *fp = fopen(filename, "r");
     if (!fp) return false;
     
-    model->table = (QEntry**)calloc(Q_TABLE_SIZE, sizeof(QEntry*));
-    model->total_entries = 0;
+    qt_init(model);
     
     char line[256];
     while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, QT_SYMMETRIC_TAG, strlen(QT_SYMMETRIC_TAG)) == 0) {
+            qt_set_symmetric(model, 1);
+            continue;
+        }
         if (line[0] == '#' || line[0] == '\n') continue;
         
         char board[9];
@@ -320,7 +324,9 @@ bool load_q_learning(const char *filename, QLearningModel *model) {
             token = strtok(NULL, ",");
             if (token) {
                 q_value = atof(token);
-                add_q_entry(model, board, action, q_value);
+                if (action >= 0 && action < 9) {
+                    qt_set(model, qt_state(board), action, (float)q_value, 1);
+                }
             }
         }
     }
@@ -329,17 +335,9 @@ bool load_q_learning(const char *filename, QLearningModel *model) {
     return model->total_entries > 0;
 }
 
-double get_q_value(const QLearningModel *model, const char board[9], int action) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = model->table[hash];
-    
-    while (entry) {
-        if (entry->action == action && memcmp(entry->board, board, 9) == 0) {
-            return entry->q_value;
-        }
-        entry = entry->next;
-    }
-    return 0.0;
+// Q(board, action) for the board's row index (qt_state)
+double get_q_value(const QLearningModel *model, int state, int action) {
+    return qt_value(model, state, action);
 }
 
 char decode_feature(double val) {
@@ -354,12 +352,13 @@ int predict_q_learning(const QLearningModel *model, const double features[]) {
         board[i] = decode_feature(features[i]);
     }
     
+    int state = qt_state(board);
     double best_q = -999999.0;
     int best_action = -1;
     
     for (int action = 0; action < 9; action++) {
         if (board[action] == 'b') {
-            double q = get_q_value(model, board, action);
+            double q = get_q_value(model, state, action);
             if (q > best_q) {
                 best_q = q;
                 best_action = action;
@@ -576,7 +575,7 @@ int main(int argc, char *argv[]) {
         print_error_matrix(&error_matrix, "NAIVE BAYES");
         
     } else if (strcmp(model_type, "q_learning") == 0) {
-        QLearningModel model;
+        static QLearningModel model;
         if (!load_q_learning(model_file, &model)) {
             printf("Error: Failed to load Q-Learning model\n");
             return 1;
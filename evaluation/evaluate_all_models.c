@@ -3,8 +3,9 @@
 #include <string.h>
 #include <time.h>
 
+#include "../TTTGUI/qtable.h"
+
 #define BOARD_SIZE 9
-#define Q_TABLE_SIZE 20000
 
 // Model types
 typedef enum {
@@ -14,19 +15,9 @@ typedef enum {
     MODEL_MINIMAX_HARD
 } ModelType;
 
-// Q-Learning structures
-typedef struct QEntry {
-    char board[9];
-    int action;
-    double q_value;
-    int visits;
-    struct QEntry *next;
-} QEntry;
-
-typedef struct {
-    QEntry *table[Q_TABLE_SIZE];
-    int total_entries;
-} QLearningModel;
+// Q-Learning model: the direct-indexed table shared with the GUI
+// (~1.4 MB: keep it static)
+typedef QTable QLearningModel;
 
 // Game functions
 char check_winner(const char board[9]) {
@@ -59,48 +50,23 @@ int get_valid_moves(const char board[9], int moves[9]) {
 }
 
 // Q-Learning functions
-unsigned long hash_board(const char board[9]) {
-    unsigned long hash = 5381;
-    for (int i = 0; i < 9; i++) {
-        hash = ((hash << 5) + hash) + board[i];
-    }
-    return hash % Q_TABLE_SIZE;
-}
-
-double get_q_value(const QLearningModel *model, const char board[9], int action) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = model->table[hash];
-    
-    while (entry != NULL) {
-        if (entry->action == action && memcmp(entry->board, board, 9) == 0) {
-            return entry->q_value;
-        }
-        entry = entry->next;
-    }
-    return 0.0;
-}
-
-void add_q_entry(QLearningModel *model, char board[9], int action, double q_value, int visits) {
-    unsigned long hash = hash_board(board);
-    QEntry *new_entry = (QEntry *)malloc(sizeof(QEntry));
-    memcpy(new_entry->board, board, 9);
-    new_entry->action = action;
-    new_entry->q_value = q_value;
-    new_entry->visits = visits;
-    new_entry->next = model->table[hash];
-    model->table[hash] = new_entry;
-    model->total_entries++;
+// Q(board, action) for the board's row index (qt_state)
+double get_q_value(const QLearningModel *model, int state, int action) {
+    return qt_value(model, state, action);
 }
 
 int ql_load_model(const char *filename, QLearningModel *model) {
     FILE *fp = fopen(filename, "r");
     if (!fp) return 0;
     
-    for (int i = 0; i < Q_TABLE_SIZE; i++) model->table[i] = NULL;
-    model->total_entries = 0;
+    qt_init(model);
     
     char line[256];
     while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, QT_SYMMETRIC_TAG, strlen(QT_SYMMETRIC_TAG)) == 0) {
+            qt_set_symmetric(model, 1);
+            continue;
+        }
         if (line[0] == '#' || line[0] == '\n') continue;
         
         char board[9];
@@ -120,7 +86,9 @@ int ql_load_model(const char *filename, QLearningModel *model) {
                 q_value = atof(token);
                 token = strtok(NULL, ",\n");
                 if (token != NULL) visits = atoi(token);
-                add_q_entry(model, board, action, q_value, visits);
+                if (action >= 0 && action < 9) {
+                    qt_set(model, qt_state(board), action, (float)q_value, visits);
+                }
             }
         }
     }
@@ -136,11 +104,12 @@ int ql_choose_move(const QLearningModel *model, const char board[9]) {
     }
     if (num == 0) return -1;
     
+    int state = qt_state(board);
     int best_move = valid_moves[0];
-    double best_q = get_q_value(model, board, best_move);
+    double best_q = get_q_value(model, state, best_move);
     
     for (int i = 1; i < num; i++) {
-        double q = get_q_value(model, board, valid_moves[i]);
+        double q = get_q_value(model, state, valid_moves[i]);
         if (q > best_q) {
             best_q = q;
             best_move = valid_moves[i];
@@ -344,7 +313,7 @@ int main() {
     printf("========================================\n");
     printf("Testing all available models...\n");
     
-    QLearningModel ql_scratch, ql_dataset, ql_continuous;
+    static QLearningModel ql_scratch, ql_dataset, ql_continuous;
     
     // Load models
     printf("\nLoading Q-Learning (From-Scratch)...\n");
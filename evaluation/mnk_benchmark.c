@@ -0,0 +1,97 @@
+// mnk_benchmark.c - self-play timing for the m,n,k engine
+//
+// Build: gcc -O2 mnk_benchmark.c ../TTTGUI/mnk_engine.c -o mnk_benchmark
+// Usage: mnk_benchmark [ms_per_move]   (default 200)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../TTTGUI/mnk_engine.h"
+
+typedef struct {
+    int rows, cols, k;
+} BoardSize;
+
+static void print_board(const char *b, int rows, int cols) {
+    for (int r = 0; r < rows; r++) {
+        printf("  ");
+        for (int c = 0; c < cols; c++) {
+            char ch = b[r * cols + c];
+            printf("%c ", ch == ' ' ? '.' : ch);
+        }
+        printf("\n");
+    }
+}
+
+// One engine-vs-engine game; prints per-move depth and speed
+static void play_game(BoardSize size, double ms_per_move) {
+    MnkEngine e;
+    char board[MNK_MAX_CELLS];
+    char player = 'X';
+    int move_no = 0;
+    unsigned long total_nodes = 0;
+    double total_ms = 0.0;
+
+    if (!mnk_init(&e, size.rows, size.cols, size.k)) {
+        printf("Unsupported board %dx%d k=%d\n", size.rows, size.cols, size.k);
+        return;
+    }
+
+    memset(board, ' ', sizeof(board));
+
+    printf("\n========================================\n");
+    printf("%dx%d, k=%d  (%d lines, %.0f ms/move)\n",
+           size.rows, size.cols, size.k, e.num_lines, ms_per_move);
+    printf("========================================\n");
+    printf("Move  Side  Cell  Depth       Nodes      ms   kNodes/s\n");
+
+    while (mnk_winner(&e, board) == 0) {
+        MnkSearchInfo info;
+        int mv = mnk_search(&e, board, player, ms_per_move, 0, &info);
+        if (mv < 0) break;
+
+        board[mv] = player;
+        move_no++;
+        total_nodes += info.nodes;
+        total_ms += info.ms;
+
+        printf("%4d    %c   %4d  %5d  %10lu  %6.1f  %9.1f\n",
+               move_no, player, mv, info.depth, info.nodes, info.ms,
+               info.ms > 0.0 ? info.nodes / info.ms : 0.0);
+
+        player = (player == 'X') ? 'O' : 'X';
+    }
+
+    int result = mnk_winner(&e, board);
+    printf("\nFinal position:\n");
+    print_board(board, size.rows, size.cols);
+    printf("Result: %s\n", result == 1 ? "X wins" : result == 2 ? "O wins" : "Draw");
+    printf("Total: %lu nodes in %.1f ms (%.1f kNodes/s)\n",
+           total_nodes, total_ms, total_ms > 0.0 ? total_nodes / total_ms : 0.0);
+
+    mnk_free(&e);
+}
+
+int main(int argc, char *argv[]) {
+    BoardSize sizes[] = {
+        {3, 3, 3},
+        {4, 4, 4},
+        {5, 5, 4}
+    };
+    double ms_per_move = 200.0;
+
+    if (argc > 1) {
+        ms_per_move = atof(argv[1]);
+    }
+
+    printf("========================================\n");
+    printf("M,N,K ENGINE BENCHMARK\n");
+    printf("Iterative deepening alpha-beta, per-move deadline\n");
+    printf("========================================\n");
+
+    for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+        play_game(sizes[i], ms_per_move);
+    }
+
+    return 0;
+}
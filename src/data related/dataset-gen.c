@@ -2,6 +2,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "../../TTTGUI/bitboard.h"
 
 #define BOARD_SIZE 9
 #define MAX_STATES 20000
@@ -18,6 +23,7 @@ typedef enum {
 typedef struct {
     char board[BOARD_SIZE];  // 'x', 'o', or 'b'
     char outcome[5];         // "win", "lose", "draw"
+    int depth_to_end;        // plies left with perfect play, -1 if not known
 } BoardState;
 
 // Structure for dataset
@@ -47,14 +53,33 @@ typedef struct {
     int misses;
 } MemoTable;
 
+// Retrograde table: value (X's point of view) and plies to the end for
+// every base-3 board encoding (digit i = cell i: 0 'b', 1 'x', 2 'o')
+typedef struct {
+    signed char value[BB_STATES];        // WIN / DRAW / LOSE, CONTINUE if unreachable
+    unsigned char depth[BB_STATES];
+} RetroTable;
+
+// Which solver labels the non-terminal states
+typedef enum {
+    SOLVER_RETROGRADE,
+    SOLVER_MINIMAX,
+    SOLVER_COMPARE
+} SolverMode;
+
 // Function prototypes
 void init_dataset(Dataset *dataset);
 void free_dataset(Dataset *dataset);
-void add_to_dataset(Dataset *dataset, char board[BOARD_SIZE], const char *outcome);
+void add_to_dataset(Dataset *dataset, char board[BOARD_SIZE], const char *outcome, int depth_to_end);
 int check_winner(char board[BOARD_SIZE]);
 int is_valid_state(char board[BOARD_SIZE]);
 int minimax(char board[BOARD_SIZE], int is_maximizing, int alpha, int beta, MemoTable *memo);
 void generate_all_states(Dataset *dataset, int include_terminal, int include_non_terminal, MemoTable *memo);
+void retrograde_label(RetroTable *rt, int idx, uint16_t x, uint16_t o, const unsigned char has_win[512]);
+void retrograde_solve(RetroTable *rt);
+void generate_all_states_retrograde(Dataset *dataset, int include_terminal, int include_non_terminal, const RetroTable *rt);
+double wall_seconds(void);
+int datasets_identical(Dataset *a, Dataset *b);
 void save_dataset(const char *filename, Dataset *dataset);
 void print_statistics(Dataset *dataset);
 void display_board(char board[BOARD_SIZE]);
@@ -85,7 +110,7 @@ void free_dataset(Dataset *dataset) {
 }
 
 // Add board state to dataset
-void add_to_dataset(Dataset *dataset, char board[BOARD_SIZE], const char *outcome) {
+void add_to_dataset(Dataset *dataset, char board[BOARD_SIZE], const char *outcome, int depth_to_end) {
     if (dataset->count >= dataset->capacity) {
         dataset->capacity *= 2;
         dataset->states = (BoardState *)realloc(dataset->states, 
@@ -94,6 +119,7 @@ void add_to_dataset(Dataset *dataset, char board[BOARD_SIZE], const char *outcom
     
     memcpy(dataset->states[dataset->count].board, board, BOARD_SIZE);
     strcpy(dataset->states[dataset->count].outcome, outcome);
+    dataset->states[dataset->count].depth_to_end = depth_to_end;
     dataset->count++;
     
     // Update statistics
@@ -376,8 +402,8 @@ void generate_state_recursive(char board[BOARD_SIZE], int pos, Dataset *dataset,
             }
         }
         
-        // Add to dataset
-        add_to_dataset(dataset, board, outcome);
+        // Add to dataset (terminal states end here; minimax gives no depth)
+        add_to_dataset(dataset, board, outcome, is_terminal ? 0 : -1);
         return;
     }
     
@@ -404,6 +430,190 @@ void generate_all_states(Dataset *dataset, int include_terminal,
     printf("✓ Generated %d valid game states\n", dataset->count);
 }
 
+// Base-3 digit weights for RetroTable indices
+static const int POW3[BOARD_SIZE] = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+
+// Label one position from its (already solved) children. x/o are the
+// cells held by each side; has_win[m] says whether mask m has a line.
+void retrograde_label(RetroTable *rt, int idx, uint16_t x, uint16_t o, 
+                      const unsigned char has_win[512]) {
+    int x_count = bb_popcount(x);
+    int o_count = bb_popcount(o);
+    int x_wins = has_win[x];
+    int o_wins = has_win[o];
+    
+    rt->value[idx] = CONTINUE;
+    rt->depth[idx] = 0;
+    
+    // Same rules as is_valid_state(): unreachable states stay CONTINUE
+    if (!(x_count == o_count || x_count == o_count + 1) ||
+        (x_wins && o_wins) ||
+        (x_wins && x_count != o_count + 1) ||
+        (o_wins && x_count != o_count)) {
+        return;
+    }
+    
+    // Terminal states
+    if (x_wins) {
+        rt->value[idx] = WIN;
+        return;
+    }
+    if (o_wins) {
+        rt->value[idx] = LOSE;
+        return;
+    }
+    if ((x | o) == BB_FULL) {
+        rt->value[idx] = DRAW;
+        return;
+    }
+    
+    // X maximizes, O minimizes. The side getting the better result
+    // ends the game as soon as it can; the other side drags it out.
+    int is_x_turn = (x_count == o_count);
+    int best = is_x_turn ? -2 : 2;
+    int best_depth = 0;
+    
+    for (unsigned m = ~(unsigned)(x | o) & BB_FULL; m; m &= m - 1) {
+        int child = idx + POW3[bb_first(m)] * (is_x_turn ? 1 : 2);
+        int value = rt->value[child];
+        int depth = rt->depth[child] + 1;
+        int mover_wins = is_x_turn ? (value == WIN) : (value == LOSE);
+        
+        if ((is_x_turn ? value > best : value < best) ||
+            (value == best && (mover_wins ? depth < best_depth : depth > best_depth))) {
+            best = value;
+            best_depth = depth;
+        }
+    }
+    
+    rt->value[idx] = (signed char)best;
+    rt->depth[idx] = (unsigned char)best_depth;
+}
+
+// Retrograde analysis: label every position in one backward pass.
+// A child always has a larger base-3 index than its parent (one more
+// digit set), so walking indices from high to low visits every child
+// before its parents - no recursion and no hashing needed.
+void retrograde_solve(RetroTable *rt) {
+    unsigned char has_win[512];
+    int digit[BOARD_SIZE];
+    uint16_t x = 0, o = BB_FULL;    // highest index: every cell 'o'
+    
+    for (int m = 0; m < 512; m++) {
+        has_win[m] = (unsigned char)bb_has_win((uint16_t)m);
+    }
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        digit[i] = 2;
+    }
+    
+    for (int idx = BB_STATES - 1; idx >= 0; idx--) {
+        retrograde_label(rt, idx, x, o, has_win);
+        
+        // Step to idx - 1: decrement the base-3 digits, cell 0 lowest
+        for (int pos = 0; pos < BOARD_SIZE; pos++) {
+            uint16_t bit = (uint16_t)(1u << pos);
+            if (digit[pos] > 0) {
+                digit[pos]--;
+                o &= (uint16_t)~bit;
+                if (digit[pos] == 1) {
+                    x |= bit;
+                } else {
+                    x &= (uint16_t)~bit;
+                }
+                break;
+            }
+            digit[pos] = 2;
+            x &= (uint16_t)~bit;
+            o |= bit;
+        }
+    }
+}
+
+// Same states in the same order as generate_state_recursive() (cell 0
+// varies slowest, each cell tried as 'x', 'o', 'b'), labelled from the
+// retrograde table instead of a search per state
+void generate_all_states_retrograde(Dataset *dataset, int include_terminal, 
+                                    int include_non_terminal, const RetroTable *rt) {
+    static const char values[] = {'x', 'o', 'b'};
+    static const int code[] = {1, 2, 0};      // RetroTable digit of each value
+    int digit[BOARD_SIZE];
+    char board[BOARD_SIZE];
+    int idx = 0;
+    int pos;
+    
+    printf("Generating all valid board states (retrograde)...\n");
+    
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        digit[i] = 0;
+        board[i] = values[0];
+        idx += code[0] * POW3[i];
+    }
+    
+    do {
+        int value = rt->value[idx];
+        
+        if (value != CONTINUE) {
+            int is_terminal = (rt->depth[idx] == 0);
+            
+            if ((is_terminal && include_terminal) || (!is_terminal && include_non_terminal)) {
+                const char *outcome = (value == WIN) ? "win" :
+                                      (value == LOSE) ? "lose" : "draw";
+                
+                if (is_terminal) {
+                    dataset->terminal++;
+                } else {
+                    dataset->non_terminal++;
+                }
+                add_to_dataset(dataset, board, outcome, rt->depth[idx]);
+            }
+        }
+        
+        // Next fill: advance the last cell first, carrying leftwards
+        for (pos = BOARD_SIZE - 1; pos >= 0; pos--) {
+            idx -= code[digit[pos]] * POW3[pos];
+            if (++digit[pos] < 3) {
+                board[pos] = values[digit[pos]];
+                idx += code[digit[pos]] * POW3[pos];
+                break;
+            }
+            digit[pos] = 0;
+            board[pos] = values[0];
+            idx += code[0] * POW3[pos];
+        }
+    } while (pos >= 0);
+    
+    printf("\n✓ Generation complete!\n");
+    printf("✓ Generated %d valid game states\n", dataset->count);
+}
+
+// Wall-clock seconds (for comparing the two solvers)
+double wall_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+// Check that both solvers produced the same file contents
+int datasets_identical(Dataset *a, Dataset *b) {
+    if (a->count != b->count) {
+        return 0;
+    }
+    for (int i = 0; i < a->count; i++) {
+        if (memcmp(a->states[i].board, b->states[i].board, BOARD_SIZE) != 0 ||
+            strcmp(a->states[i].outcome, b->states[i].outcome) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 // Display board
 void display_board(char board[BOARD_SIZE]) {
     printf("\n");
@@ -446,6 +656,22 @@ void print_statistics(Dataset *dataset) {
     printf("  Draws (draw):   %5d (%5.2f%%)\n", 
            dataset->draws, 
            (dataset->draws * 100.0) / dataset->count);
+    
+    // Depth-to-end is only known when the retrograde solver labelled the states
+    int depth_states = 0, depth_total = 0, depth_max = 0;
+    for (int i = 0; i < dataset->count; i++) {
+        int d = dataset->states[i].depth_to_end;
+        if (d > 0) {
+            depth_states++;
+            depth_total += d;
+            if (d > depth_max) depth_max = d;
+        }
+    }
+    if (depth_states > 0) {
+        printf("\nPlies to end with perfect play (non-terminal):\n");
+        printf("  Average: %.2f, longest: %d\n", 
+               (double)depth_total / depth_states, depth_max);
+    }
     printf("========================================\n");
     
     printf("\n💡 KEY INSIGHT:\n");
@@ -501,18 +727,27 @@ void show_examples(Dataset *dataset) {
             printf("----------------------------------------\n");
             display_board(state->board);
             printf("Minimax evaluation: %s\n", state->outcome);
+            if (state->depth_to_end >= 0) {
+                printf("Plies to end: %d\n", state->depth_to_end);
+            }
             shown_win = 1;
         } else if (!shown_draw && strcmp(state->outcome, "draw") == 0) {
             printf("\nPERFECT PLAY → DRAW:\n");
             printf("----------------------------------------\n");
             display_board(state->board);
             printf("Minimax evaluation: %s\n", state->outcome);
+            if (state->depth_to_end >= 0) {
+                printf("Plies to end: %d\n", state->depth_to_end);
+            }
             shown_draw = 1;
         } else if (!shown_lose && strcmp(state->outcome, "lose") == 0) {
             printf("\nX WILL LOSE:\n");
             printf("----------------------------------------\n");
             display_board(state->board);
             printf("Minimax evaluation: %s\n", state->outcome);
+            if (state->depth_to_end >= 0) {
+                printf("Plies to end: %d\n", state->depth_to_end);
+            }
             shown_lose = 1;
         }
     }
@@ -520,7 +755,21 @@ void show_examples(Dataset *dataset) {
     printf("========================================\n");
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+    // Solver for non-terminal labels: retrograde pass (default), the
+    // original per-state minimax, or both with a timing comparison
+    SolverMode solver = SOLVER_RETROGRADE;
+    if (argc > 1) {
+        if (strcmp(argv[1], "minimax") == 0) {
+            solver = SOLVER_MINIMAX;
+        } else if (strcmp(argv[1], "compare") == 0) {
+            solver = SOLVER_COMPARE;
+        } else if (strcmp(argv[1], "retrograde") != 0) {
+            printf("Usage: %s [retrograde|minimax|compare]\n", argv[0]);
+            return 1;
+        }
+    }
+    
     printf("========================================\n");
     printf("OPTIMAL TIC-TAC-TOE DATASET GENERATOR\n");
     printf("Using Minimax Algorithm (C Implementation)\n");
@@ -563,22 +812,57 @@ int main() {
     }
     
     // Initialize
-    Dataset dataset;
+    Dataset dataset;            // labelled by the chosen solver, saved below
+    Dataset minimax_dataset;    // compare mode: second copy from minimax
     MemoTable memo;
+    RetroTable rt;
+    double minimax_time = 0.0, retro_time = 0.0;
     init_dataset(&dataset);
-    init_memo_table(&memo);
     
     // Generate dataset
-    clock_t start = clock();
-    generate_all_states(&dataset, include_terminal, include_non_terminal, &memo);
-    clock_t end = clock();
+    if (solver != SOLVER_RETROGRADE) {
+        Dataset *target = (solver == SOLVER_MINIMAX) ? &dataset : &minimax_dataset;
+        if (solver == SOLVER_COMPARE) {
+            init_dataset(&minimax_dataset);
+        }
+        init_memo_table(&memo);
+        
+        double start = wall_seconds();
+        generate_all_states(target, include_terminal, include_non_terminal, &memo);
+        minimax_time = wall_seconds() - start;
+        
+        printf("\n⏱️  Minimax generation time: %.4f seconds (wall)\n", minimax_time);
+        printf("📊 Memoization hits: %d, misses: %d (hit rate: %.2f%%)\n",
+               memo.hits, memo.misses, 
+               (memo.hits * 100.0) / (memo.hits + memo.misses));
+        free_memo_table(&memo);
+    }
     
-    double time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
+    if (solver != SOLVER_MINIMAX) {
+        double start = wall_seconds();
+        retrograde_solve(&rt);
+        generate_all_states_retrograde(&dataset, include_terminal, include_non_terminal, &rt);
+        retro_time = wall_seconds() - start;
+        
+        printf("\n⏱️  Retrograde generation time: %.4f seconds (wall)\n", retro_time);
+    }
     
-    printf("\n⏱️  Generation time: %.2f seconds\n", time_taken);
-    printf("📊 Memoization hits: %d, misses: %d (hit rate: %.2f%%)\n",
-           memo.hits, memo.misses, 
-           (memo.hits * 100.0) / (memo.hits + memo.misses));
+    if (solver == SOLVER_COMPARE) {
+        printf("\n========================================\n");
+        printf("SOLVER COMPARISON\n");
+        printf("========================================\n");
+        printf("  Minimax (alpha-beta + memo): %.4f s\n", minimax_time);
+        printf("  Retrograde (one pass):       %.4f s\n", retro_time);
+        if (retro_time > 0.0) {
+            printf("  Speedup: %.1fx\n", minimax_time / retro_time);
+        }
+        if (datasets_identical(&dataset, &minimax_dataset)) {
+            printf("  ✓ Both solvers produce identical output\n");
+        } else {
+            printf("  ✗ WARNING: solvers disagree - check the labels!\n");
+        }
+        free_dataset(&minimax_dataset);
+    }
     
     // Print statistics
     print_statistics(&dataset);
@@ -611,7 +895,6 @@ int main() {
     
     // Cleanup
     free_dataset(&dataset);
-    free_memo_table(&memo);
     
     return 0;
 }
\ No newline at end of file
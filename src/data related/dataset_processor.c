@@ -3,6 +3,8 @@
 #include <string.h>
 #include <time.h>
 
+#include "../../TTTGUI/dataset_file.h"
+
 #define FEATURES 9
 #define INITIAL_CAPACITY 1000  // Start with 1000, will expand as needed
 
@@ -24,9 +26,14 @@ void initDataset(Dataset *dataset);
 void expandDataset(Dataset *dataset);
 void freeDataset(Dataset *dataset);
 int readDataset(const char *filename, Dataset *dataset);
+int readDatasetBinary(const char *filename, Dataset *dataset);
+int isMatrixDataset(const char *filename);
+int readDatasetMatrix(const char *filename, Dataset *dataset);
 void shuffleDataset(Dataset *dataset);
 void splitDataset(Dataset *full, Dataset *train, Dataset *test, double train_ratio);
 int saveDataset(const char *filename, Dataset *dataset);
+int saveDatasetBinary(const char *filename, Dataset *dataset);
+int convertDataset(const char *mode, const char *input, const char *output);
 int saveReport(const char *filename, Dataset *full, Dataset *train, Dataset *test);
 void printSample(Sample *s);
 void displayBoard(Sample *s);
@@ -81,8 +88,101 @@ void shuffleDataset(Dataset *dataset) {
     printf("Dataset shuffled randomly\n");
 }
 
-// Function to open and read the dataset file (DYNAMIC SIZE)
+// Read a packed binary dataset (dataset_file.h) in one go
+int readDatasetBinary(const char *filename, Dataset *dataset) {
+    int count;
+    DsRecord *records = ds_read(filename, &count);
+    if (records == NULL) {
+        return 0;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        if (dataset->size >= dataset->capacity) {
+            expandDataset(dataset);
+        }
+        
+        Sample *s = &dataset->data[dataset->size++];
+        ds_record_cells(&records[i], s->features);
+        s->outcome = ds_label_name(records[i].label)[0];  // 'w', 'l' or 'd'
+    }
+    
+    free(records);
+    printf("Successfully loaded %d samples from %s (packed binary)\n", count, filename);
+    return 1;
+}
+
+// Is this a matrix-format CSV (dataset_processor_matrix.c output)? Its
+// first line is a '#' comment or starts with a number, not x/o/b.
+int isMatrixDataset(const char *filename) {
+    FILE *fp = fopen(filename, "r");
+    char line[256];
+    int matrix = 0;
+    
+    if (fp == NULL) {
+        return 0;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        matrix = line[0] == '#' || line[0] == '-' || line[0] == '+' ||
+                 (line[0] >= '0' && line[0] <= '9');
+        break;
+    }
+    fclose(fp);
+    return matrix;
+}
+
+// Read a matrix-format CSV (x1..x9 as 1.0 / -1.0 / 0.0, outcome +1 / -1 / 0)
+int readDatasetMatrix(const char *filename, Dataset *dataset) {
+    FILE *fp = fopen(filename, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Could not open file %s\n", filename);
+        return 0;
+    }
+    
+    char line[256];
+    int line_num = 0;
+    
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        double v[FEATURES];
+        int outcome;
+        
+        line_num++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        if (sscanf(line, "%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%d",
+                   &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], &v[8], &outcome) != FEATURES + 1) {
+            fprintf(stderr, "Warning: Invalid matrix line %d, skipping\n", line_num);
+            continue;
+        }
+        
+        if (dataset->size >= dataset->capacity) {
+            expandDataset(dataset);
+        }
+        Sample *s = &dataset->data[dataset->size++];
+        for (int i = 0; i < FEATURES; i++) {
+            s->features[i] = v[i] > 0.5 ? 'x' : (v[i] < -0.5 ? 'o' : 'b');
+        }
+        s->outcome = outcome > 0 ? 'w' : (outcome < 0 ? 'l' : 'd');
+    }
+    
+    fclose(fp);
+    printf("Successfully loaded %d samples from %s (matrix format)\n", dataset->size, filename);
+    return 1;
+}
+
+// Function to open and read the dataset file (DYNAMIC SIZE); packed
+// binary and matrix-format files are detected by their content
 int readDataset(const char *filename, Dataset *dataset) {
+    if (ds_is_binary_file(filename)) {
+        return readDatasetBinary(filename, dataset);
+    }
+    if (isMatrixDataset(filename)) {
+        return readDatasetMatrix(filename, dataset);
+    }
+    
     FILE *fp = fopen(filename, "r");
     if (fp == NULL) {
         fprintf(stderr, "Error: Could not open file %s\n", filename);
@@ -256,6 +356,60 @@ int saveDataset(const char *filename, Dataset *dataset) {
     return 1;
 }
 
+// Function to save dataset as packed binary (dataset_file.h)
+int saveDatasetBinary(const char *filename, Dataset *dataset) {
+    DsRecord *records = (DsRecord *)malloc((dataset->size > 0 ? dataset->size : 1) * sizeof(DsRecord));
+    if (records == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        return 0;
+    }
+    
+    for (int i = 0; i < dataset->size; i++) {
+        Sample *s = &dataset->data[i];
+        int label = s->outcome == 'w' ? DS_LABEL_WIN : (s->outcome == 'l' ? DS_LABEL_LOSE : DS_LABEL_DRAW);
+        records[i] = ds_record_from_cells(s->features, label);
+    }
+    
+    int ok = ds_write(filename, records, dataset->size);
+    free(records);
+    if (!ok) {
+        fprintf(stderr, "Error: Could not create file %s\n", filename);
+        return 0;
+    }
+    
+    printf("Successfully saved %d samples to %s (packed binary)\n", dataset->size, filename);
+    return 1;
+}
+
+// Convert between CSV and packed binary without shuffling or splitting.
+// mode is --to-binary or --to-csv; the input may be character CSV,
+// matrix CSV or packed binary. An input with no valid samples is an
+// error rather than an empty output file.
+int convertDataset(const char *mode, const char *input, const char *output) {
+    Dataset dataset;
+    int ok;
+    
+    initDataset(&dataset);
+    if (!readDataset(input, &dataset)) {
+        freeDataset(&dataset);
+        return 0;
+    }
+    if (dataset.size == 0) {
+        fprintf(stderr, "Error: No valid samples in %s, nothing written\n", input);
+        freeDataset(&dataset);
+        return 0;
+    }
+    
+    if (strcmp(mode, "--to-binary") == 0) {
+        ok = saveDatasetBinary(output, &dataset);
+    } else {
+        ok = saveDataset(output, &dataset);
+    }
+    
+    freeDataset(&dataset);
+    return ok;
+}
+
 // Function to save statistics report
 int saveReport(const char *filename, Dataset *full, Dataset *train, Dataset *test) {
     FILE *fp = fopen(filename, "w");
@@ -366,6 +520,15 @@ int main(int argc, char *argv[]) {
     printf("Dynamic Size - Works with dataset-gen.c\n");
     printf("========================================\n\n");
     
+    // Format conversion: --to-binary <in> <out.tds> or --to-csv <in.tds> <out>
+    if (argc > 1 && (strcmp(argv[1], "--to-binary") == 0 || strcmp(argv[1], "--to-csv") == 0)) {
+        if (argc != 4) {
+            fprintf(stderr, "Usage: %s %s <input_file> <output_file>\n", argv[0], argv[1]);
+            return 1;
+        }
+        return convertDataset(argv[1], argv[2], argv[3]) ? 0 : 1;
+    }
+    
     // Get input filename
     if (argc > 1) {
         // Use command-line argument
@@ -492,6 +655,8 @@ int main(int argc, char *argv[]) {
     printf("\nAll files saved in the current directory.\n");
     printf("\n*** IMPORTANT: Data was randomly shuffled before splitting ***\n");
     printf("\nUsage: %s [input_file] [train_ratio]\n", argv[0]);
+    printf("       %s --to-binary <input.data> <output.tds>  (character or matrix CSV)\n", argv[0]);
+    printf("       %s --to-csv <input.tds> <output.data>\n", argv[0]);
     printf("Example: %s tic-tac-toe-minimax-complete.data 0.8\n", argv[0]);
     printf("Example: %s tic-tac-toe-minimax-non-terminal.data 0.8\n", argv[0]);
     
@@ -3,21 +3,41 @@
 #include <string.h>
 #include <time.h>
 
-#define MAX_SAMPLES 10000
+#include "../../TTTGUI/dataset_file.h"
+
 #define FEATURES 9
+#define INITIAL_CAPACITY 1024  // Samples; doubled as needed
+#define CACHE_LINE 64          // Alignment of the feature buffer, in bytes
+
+// Storage order of the feature buffer
+#define LAYOUT_ROW 0           // sample m at X + m * FEATURES
+#define LAYOUT_COL 1           // feature n at X + n * stride
 
 // Matrix-based dataset structure
+//
+// Features live in one contiguous, cache-line-aligned buffer; y is
+// parallel to its storage rows. index[m] is the storage row of sample m,
+// so shuffling permutes index and a split is two ranges of it sharing the
+// parent's buffers. Always access samples through getX / getY.
 typedef struct {
-    double **X;      // 2D array: X[m][n] - features (m samples, n=9 features)
-    int *y;          // 1D array: y[m] - outcomes (+1 win, -1 lose)
+    double *X;       // features (m samples, n=9), laid out as `layout`
+    int *y;          // outcomes by storage row (+1 win, 0 draw, -1 lose)
+    int *index;      // index[m] - storage row of sample m
     int num_samples; // m - number of samples
     int num_features;// n - number of features (always 9)
+    int capacity;    // storage rows allocated
+    int stride;      // doubles between features of one sample (LAYOUT_COL)
+    int layout;      // LAYOUT_ROW or LAYOUT_COL
+    int owns_data;   // 0 for a split view of another dataset
 } MatrixDataset;
 
 // Function prototypes
-void initMatrixDataset(MatrixDataset *dataset, int max_samples);
+void initMatrixDataset(MatrixDataset *dataset, int capacity, int layout);
+void growMatrixDataset(MatrixDataset *dataset);
+void addMatrixSample(MatrixDataset *dataset, const double *features, int outcome);
 void freeMatrixDataset(MatrixDataset *dataset);
 int readDatasetToMatrix(const char *filename, MatrixDataset *dataset);
+int readBinaryToMatrix(const char *filename, MatrixDataset *dataset);
 void shuffleMatrix(MatrixDataset *dataset);
 void splitMatrix(MatrixDataset *full, MatrixDataset *train, MatrixDataset *test, double train_ratio);
 int saveMatrixDataset(const char *filename, MatrixDataset *dataset);
@@ -41,54 +61,167 @@ char decodeFeature(double val) {
     return 'b';
 }
 
-void initMatrixDataset(MatrixDataset *dataset, int max_samples) {
+static void *alignedAlloc(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, CACHE_LINE);
+#else
+    void *p = NULL;
+    return posix_memalign(&p, CACHE_LINE, size) == 0 ? p : NULL;
+#endif
+}
+
+static void alignedFree(void *p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// Address of feature n of storage row r
+static inline double *featureAt(const MatrixDataset *dataset, int r, int n) {
+    return dataset->layout == LAYOUT_COL ? dataset->X + (size_t)n * dataset->stride + r
+                                         : dataset->X + (size_t)r * FEATURES + n;
+}
+
+// X[m][n] and y[m] of sample m
+static inline double getX(const MatrixDataset *dataset, int m, int n) {
+    return *featureAt(dataset, dataset->index[m], n);
+}
+
+static inline int getY(const MatrixDataset *dataset, int m) {
+    return dataset->y[dataset->index[m]];
+}
+
+// Allocate buffers for `capacity` storage rows; returns 0 if out of memory.
+// Columns are padded so each one starts on a cache line.
+static int allocMatrixStorage(MatrixDataset *dataset, int capacity) {
+    int per_line = CACHE_LINE / (int)sizeof(double);
+    int stride = (capacity + per_line - 1) / per_line * per_line;
+    
+    dataset->X = (double *)alignedAlloc((size_t)stride * FEATURES * sizeof(double));
+    dataset->y = (int *)malloc((size_t)capacity * sizeof(int));
+    dataset->index = (int *)malloc((size_t)capacity * sizeof(int));
+    if (dataset->X == NULL || dataset->y == NULL || dataset->index == NULL) {
+        alignedFree(dataset->X);
+        free(dataset->y);
+        free(dataset->index);
+        return 0;
+    }
+    dataset->capacity = capacity;
+    dataset->stride = stride;
+    return 1;
+}
+
+void initMatrixDataset(MatrixDataset *dataset, int capacity, int layout) {
     dataset->num_features = FEATURES;
     dataset->num_samples = 0;
+    dataset->layout = layout;
+    dataset->owns_data = 1;
     
-    dataset->X = (double **)malloc(max_samples * sizeof(double *));
-    if (dataset->X == NULL) {
+    if (!allocMatrixStorage(dataset, capacity > 0 ? capacity : 1)) {
         fprintf(stderr, "Error: Memory allocation failed for feature matrix\n");
         exit(1);
     }
     
-    for (int i = 0; i < max_samples; i++) {
-        dataset->X[i] = (double *)malloc(FEATURES * sizeof(double));
-        if (dataset->X[i] == NULL) {
-            fprintf(stderr, "Error: Memory allocation failed for feature row %d\n", i);
-            exit(1);
+    printf("Matrix dataset initialized: X[%d][%d], y[%d] (%s-major, %d-byte aligned)\n", 
+           dataset->capacity, FEATURES, dataset->capacity,
+           layout == LAYOUT_COL ? "column" : "row", CACHE_LINE);
+}
+
+// Double the capacity, keeping the samples and the layout
+void growMatrixDataset(MatrixDataset *dataset) {
+    MatrixDataset old = *dataset;
+    
+    if (!allocMatrixStorage(dataset, old.capacity * 2)) {
+        fprintf(stderr, "Error: Memory reallocation failed\n");
+        freeMatrixDataset(&old);
+        exit(1);
+    }
+    
+    if (dataset->layout == LAYOUT_COL) {
+        for (int n = 0; n < FEATURES; n++) {
+            memcpy(featureAt(dataset, 0, n), featureAt(&old, 0, n), old.num_samples * sizeof(double));
         }
+    } else {
+        memcpy(dataset->X, old.X, (size_t)old.num_samples * FEATURES * sizeof(double));
     }
+    memcpy(dataset->y, old.y, old.num_samples * sizeof(int));
+    memcpy(dataset->index, old.index, old.num_samples * sizeof(int));
+    freeMatrixDataset(&old);
     
-    dataset->y = (int *)malloc(max_samples * sizeof(int));
-    if (dataset->y == NULL) {
-        fprintf(stderr, "Error: Memory allocation failed for outcome vector\n");
-        exit(1);
+    printf("Matrix capacity expanded to %d samples\n", dataset->capacity);
+}
+
+// Append one sample, growing the buffers when full
+void addMatrixSample(MatrixDataset *dataset, const double *features, int outcome) {
+    if (dataset->num_samples >= dataset->capacity) {
+        growMatrixDataset(dataset);
     }
     
-    printf("Matrix dataset initialized: X[%d][%d], y[%d]\n", 
-           max_samples, FEATURES, max_samples);
+    int r = dataset->num_samples++;
+    for (int n = 0; n < FEATURES; n++) {
+        *featureAt(dataset, r, n) = features[n];
+    }
+    dataset->y[r] = outcome;
+    dataset->index[r] = r;
 }
 
 void freeMatrixDataset(MatrixDataset *dataset) {
-    if (dataset->X != NULL) {
-        for (int i = 0; i < MAX_SAMPLES; i++) {
-            if (dataset->X[i] != NULL) {
-                free(dataset->X[i]);
-            }
-        }
-        free(dataset->X);
-        dataset->X = NULL;
+    if (dataset->owns_data) {
+        alignedFree(dataset->X);
+        free(dataset->y);
+        free(dataset->index);
+    }
+    dataset->X = NULL;
+    dataset->y = NULL;
+    dataset->index = NULL;
+    dataset->num_samples = 0;
+    dataset->capacity = 0;
+}
+
+// Print what readDatasetToMatrix / readBinaryToMatrix loaded
+static void printMatrixLoadSummary(const char *filename, int valid_samples,
+                                   int win_count, int draw_count, int lose_count) {
+    printf("Successfully loaded %d samples from %s\n", valid_samples, filename);
+    printf("  - Win samples: %d (y[m] = +1, %.1f%%)\n", win_count, 100.0 * win_count / valid_samples);
+    printf("  - Draw samples: %d (y[m] = 0, %.1f%%)\n", draw_count, 100.0 * draw_count / valid_samples);
+    printf("  - Lose samples: %d (y[m] = -1, %.1f%%)\n", lose_count, 100.0 * lose_count / valid_samples);
+    printf("\nMatrix dimensions: X[%d][%d], y[%d]\n", 
+           valid_samples, FEATURES, valid_samples);
+}
+
+// Read a packed binary dataset (dataset_file.h) into matrix format
+int readBinaryToMatrix(const char *filename, MatrixDataset *dataset) {
+    int count;
+    int win_count = 0, draw_count = 0, lose_count = 0;
+    DsRecord *records = ds_read(filename, &count);
+    if (records == NULL) {
+        return 0;
     }
     
-    if (dataset->y != NULL) {
-        free(dataset->y);
-        dataset->y = NULL;
+    printf("\nReading packed binary dataset into matrix format...\n");
+    
+    for (int m = 0; m < count; m++) {
+        double features[FEATURES];
+        int outcome = ds_label_value(records[m].label);
+        ds_record_features(&records[m], features);
+        addMatrixSample(dataset, features, outcome);
+        if (outcome > 0) win_count++;
+        else if (outcome < 0) lose_count++;
+        else draw_count++;
     }
     
-    dataset->num_samples = 0;
+    free(records);
+    printMatrixLoadSummary(filename, count, win_count, draw_count, lose_count);
+    return 1;
 }
 
 int readDatasetToMatrix(const char *filename, MatrixDataset *dataset) {
+    if (ds_is_binary_file(filename)) {
+        return readBinaryToMatrix(filename, dataset);
+    }
+    
     FILE *fp = fopen(filename, "r");
     if (fp == NULL) {
         fprintf(stderr, "Error: Could not open file %s\n", filename);
@@ -107,7 +240,7 @@ int readDatasetToMatrix(const char *filename, MatrixDataset *dataset) {
     printf("        y[m] where values are +1 (win), 0 (draw), or -1 (lose)\n\n");
     
     // Read each line from the file
-    while (fgets(line, sizeof(line), fp) != NULL && valid_samples < MAX_SAMPLES) {
+    while (fgets(line, sizeof(line), fp) != NULL) {
         line_num++;
         
         // Remove newline character
@@ -177,81 +310,55 @@ int readDatasetToMatrix(const char *filename, MatrixDataset *dataset) {
         
         // Convert features to numerical matrix format
         // x_{m,n} where n=1..9 (square positions)
+        double row[FEATURES];
         for (int n = 0; n < FEATURES; n++) {
-            dataset->X[valid_samples][n] = encodeFeature(features[n]);
+            row[n] = encodeFeature(features[n]);
         }
         
-        // Store outcome: y_{m,1}
-        dataset->y[valid_samples] = outcome;
+        // Store the row and its outcome y_{m,1}
+        addMatrixSample(dataset, row, outcome);
         
         valid_samples++;
     }
     
     fclose(fp);
-    dataset->num_samples = valid_samples;
     
-    printf("Successfully loaded %d samples from %s\n", valid_samples, filename);
-    printf("  - Win samples: %d (y[m] = +1, %.1f%%)\n", win_count, 100.0 * win_count / valid_samples);
-    printf("  - Draw samples: %d (y[m] = 0, %.1f%%)\n", draw_count, 100.0 * draw_count / valid_samples);
-    printf("  - Lose samples: %d (y[m] = -1, %.1f%%)\n", lose_count, 100.0 * lose_count / valid_samples);
-    printf("\nMatrix dimensions: X[%d][%d], y[%d]\n", 
-           valid_samples, FEATURES, valid_samples);
+    printMatrixLoadSummary(filename, valid_samples, win_count, draw_count, lose_count);
     
     return 1;
 }
 
-// Shuffle matrix dataset using Fisher-Yates algorithm
+// Shuffle matrix dataset using Fisher-Yates algorithm on the sample
+// index; the rows themselves stay where they are
 void shuffleMatrix(MatrixDataset *dataset) {
     srand(time(NULL));
     
     for (int i = dataset->num_samples - 1; i > 0; i--) {
         int j = rand() % (i + 1);
         
-        // Swap rows in feature matrix X
-        double *temp_row = dataset->X[i];
-        dataset->X[i] = dataset->X[j];
-        dataset->X[j] = temp_row;
-        
-        // Swap corresponding outcomes in y
-        int temp_y = dataset->y[i];
-        dataset->y[i] = dataset->y[j];
-        dataset->y[j] = temp_y;
+        int temp = dataset->index[i];
+        dataset->index[i] = dataset->index[j];
+        dataset->index[j] = temp;
     }
     
     printf("Matrix dataset shuffled randomly\n");
 }
 
-// Split matrix dataset into training and testing sets
+// Split matrix dataset into training and testing sets. Both are views
+// of full (first train_ratio of its index, then the rest): nothing is
+// copied, and full must outlive them.
 void splitMatrix(MatrixDataset *full, MatrixDataset *train, MatrixDataset *test, double train_ratio) {
     int train_size = (int)(full->num_samples * train_ratio);
     int test_size = full->num_samples - train_size;
     
-    // Initialize train and test datasets
-    initMatrixDataset(train, train_size);
-    initMatrixDataset(test, test_size);
-    
+    *train = *full;
+    train->owns_data = 0;
     train->num_samples = train_size;
-    test->num_samples = test_size;
     
-    // Copy first train_ratio% to training set
-    for (int i = 0; i < train_size; i++) {
-        // Copy feature row
-        for (int j = 0; j < FEATURES; j++) {
-            train->X[i][j] = full->X[i][j];
-        }
-        // Copy outcome
-        train->y[i] = full->y[i];
-    }
-    
-    // Copy remaining to testing set
-    for (int i = 0; i < test_size; i++) {
-        // Copy feature row
-        for (int j = 0; j < FEATURES; j++) {
-            test->X[i][j] = full->X[train_size + i][j];
-        }
-        // Copy outcome
-        test->y[i] = full->y[train_size + i];
-    }
+    *test = *full;
+    test->owns_data = 0;
+    test->index = full->index + train_size;
+    test->num_samples = test_size;
     
     printf("\nMatrix dataset split:\n");
     printf("  Training set: X_train[%d][%d], y_train[%d] (%.1f%%)\n", 
@@ -272,7 +379,7 @@ void displayMatrixSample(MatrixDataset *dataset, int index) {
     
     // Display as tic-tac-toe board
     for (int i = 0; i < 9; i++) {
-        printf(" %c ", decodeFeature(dataset->X[index][i]));
+        printf(" %c ", decodeFeature(getX(dataset, index, i)));
         if ((i + 1) % 3 == 0) {
             printf("  (row %d)\n", i/3 + 1);
             if (i < 8) printf("-----------\n");
@@ -282,8 +389,8 @@ void displayMatrixSample(MatrixDataset *dataset, int index) {
     }
     
     printf("Outcome y[%d]: %s (%+d)\n", index, 
-           dataset->y[index] == 1 ? "Win" : "Lose",
-           dataset->y[index]);
+           getY(dataset, index) == 1 ? "Win" : "Lose",
+           getY(dataset, index));
 }
 
 // Save matrix dataset to file
@@ -302,11 +409,11 @@ int saveMatrixDataset(const char *filename, MatrixDataset *dataset) {
     for (int m = 0; m < dataset->num_samples; m++) {
         // Write features X[m][n]
         for (int n = 0; n < FEATURES; n++) {
-            fprintf(fp, "%.1f", dataset->X[m][n]);
+            fprintf(fp, "%.1f", getX(dataset, m, n));
             if (n < FEATURES - 1) fprintf(fp, ",");
         }
         // Write outcome y[m]
-        fprintf(fp, ",%+d\n", dataset->y[m]);
+        fprintf(fp, ",%+d\n", getY(dataset, m));
     }
     
     fclose(fp);
@@ -325,22 +432,22 @@ int saveMatrixReport(const char *filename, MatrixDataset *full, MatrixDataset *t
     // Count outcomes in full dataset
     int full_win = 0, full_lose = 0;
     for (int i = 0; i < full->num_samples; i++) {
-        if (full->y[i] == +1) full_win++;
-        else if (full->y[i] == -1) full_lose++;
+        if (getY(full, i) == +1) full_win++;
+        else if (getY(full, i) == -1) full_lose++;
     }
     
     // Count outcomes in training set
     int train_win = 0, train_lose = 0;
     for (int i = 0; i < train->num_samples; i++) {
-        if (train->y[i] == +1) train_win++;
-        else if (train->y[i] == -1) train_lose++;
+        if (getY(train, i) == +1) train_win++;
+        else if (getY(train, i) == -1) train_lose++;
     }
     
     // Count outcomes in testing set
     int test_win = 0, test_lose = 0;
     for (int i = 0; i < test->num_samples; i++) {
-        if (test->y[i] == +1) test_win++;
-        else if (test->y[i] == -1) test_lose++;
+        if (getY(test, i) == +1) test_win++;
+        else if (getY(test, i) == -1) test_lose++;
     }
     
     // Write report
@@ -422,6 +529,9 @@ int main(int argc, char *argv[]) {
     char test_filename[256];
     char report_filename[256];
     double train_ratio = 0.8;  // default 80/20 split
+    int layout = LAYOUT_ROW;
+    const char *args[2] = {NULL, NULL};
+    int num_args = 0;
     
     printf("\n");
     printf("========================================\n");
@@ -433,14 +543,23 @@ int main(int argc, char *argv[]) {
     printf("        y[m] where values ∈ {+1, 0, -1}\n");
     printf("\n");
     
+    // Options: --layout row|col selects the in-memory storage order
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--layout") == 0 && i + 1 < argc) {
+            layout = strcmp(argv[++i], "col") == 0 ? LAYOUT_COL : LAYOUT_ROW;
+        } else if (num_args < 2) {
+            args[num_args++] = argv[i];
+        }
+    }
+    
     // Get input filename
-    if (argc < 2) {
-        fprintf(stderr, "Usage: %s <input_file> [train_ratio]\n", argv[0]);
+    if (num_args < 1) {
+        fprintf(stderr, "Usage: %s <input_file> [train_ratio] [--layout row|col]\n", argv[0]);
         fprintf(stderr, "Example: %s tic-tac-toe-minimax-complete.data 0.8\n", argv[0]);
         return 1;
     }
     
-    strcpy(input_filename, argv[1]);
+    snprintf(input_filename, sizeof(input_filename), "%s", args[0]);
     
     // Determine output filenames based on input
     if (strstr(input_filename, "non-terminal") != NULL) {
@@ -461,16 +580,16 @@ int main(int argc, char *argv[]) {
     }
     
     // Get train/test split ratio
-    if (argc > 2) {
-        train_ratio = atof(argv[2]);
+    if (num_args > 1) {
+        train_ratio = atof(args[1]);
         if (train_ratio <= 0 || train_ratio >= 1) {
             fprintf(stderr, "Invalid train ratio: %.2f, using default 0.8\n", train_ratio);
             train_ratio = 0.8;
         }
     }
     
-    // Initialize and read dataset into matrix format
-    initMatrixDataset(&fullDataset, MAX_SAMPLES);
+    // Initialize and read dataset into matrix format (grows as it reads)
+    initMatrixDataset(&fullDataset, INITIAL_CAPACITY, layout);
     
     if (!readDatasetToMatrix(input_filename, &fullDataset)) {
         freeMatrixDataset(&fullDataset);
@@ -542,7 +661,8 @@ int main(int argc, char *argv[]) {
     printf("  Features: X[m][n] = numerical values\n");
     printf("  Outcomes: y[m] = {+1, 0, -1}\n");
     printf("\nKey differences from standard processor:\n");
-    printf("  ✓ True matrix format (2D array + 1D array)\n");
+    printf("  ✓ True matrix format (one aligned %s-major block + 1D array)\n",
+           layout == LAYOUT_COL ? "column" : "row");
     printf("  ✓ Numerical encoding (not characters)\n");
     printf("  ✓ Ternary classification (includes draws)\n");
     printf("  ✓ Standard ML notation (X, y)\n");
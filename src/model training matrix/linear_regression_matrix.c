@@ -3,20 +3,53 @@
 #include <string.h>
 #include <math.h>
 #include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "../model training/normal_eq.h"
+#include "../../TTTGUI/dataset_file.h"
+#include "matrix_kernels.h"
 
 #define MAX_INSTANCES 10000
 #define NUM_FEATURES 10
 #define MAX_LINE_LENGTH 256
 
-typedef struct {
-    double features[NUM_FEATURES];
-    double label;
-} Instance;
-
 typedef struct {
     double weights[NUM_FEATURES];
 } LinearModel;
-int load_matrix_data(const char *filename, Instance *data) {
+
+// Load a packed binary dataset (dataset_file.h); draws get label 0
+int load_binary_data(const char *filename, FeatureMatrix *data) {
+    int count;
+    DsRecord *records = ds_read(filename, &count);
+    if (!records) {
+        return 0;
+    }
+    
+    printf("Loading packed binary data from %s...\n", filename);
+    
+    data->rows = 0;
+    for (int i = 0; i < count && data->rows < data->capacity; i++) {
+        double row[NUM_FEATURES];
+        row[0] = 1.0;
+        ds_record_features(&records[i], &row[1]);
+        fm_add(data, row, (double)ds_label_value(records[i].label));
+    }
+    
+    free(records);
+    printf("Loaded %d samples\n", data->rows);
+    return data->rows;
+}
+
+// Samples are kept column-major in a FeatureMatrix (see matrix_kernels.h);
+// column 0 is the constant bias feature. Packed binary files are detected
+// by their header.
+int load_matrix_data(const char *filename, FeatureMatrix *data) {
+    if (ds_is_binary_file(filename)) {
+        return load_binary_data(filename, data);
+    }
+    
     FILE *file = fopen(filename, "r");
     if (!file) {
         printf("Error opening file: %s\n", filename);
@@ -24,11 +57,11 @@ int load_matrix_data(const char *filename, Instance *data) {
     }
     
     char line[MAX_LINE_LENGTH];
-    int count = 0;
     
     printf("Loading matrix format data from %s...\n", filename);
     
-    while (fgets(line, sizeof(line), file) && count < MAX_INSTANCES) {
+    data->rows = 0;
+    while (fgets(line, sizeof(line), file) && data->rows < data->capacity) {
         if (line[0] == '#') {
             continue;
         }
@@ -51,43 +84,39 @@ int load_matrix_data(const char *filename, Instance *data) {
             continue;
         }
         
-        data[count].features[0] = 1.0;
+        double row[NUM_FEATURES];
+        row[0] = 1.0;
         for (int i = 0; i < 9; i++) {
-            data[count].features[i + 1] = f[i];
+            row[i + 1] = f[i];
         }
-        data[count].label = (double)outcome;
-        
-        count++;
+        fm_add(data, row, (double)outcome);
     }
     
     fclose(file);
-    printf("Loaded %d samples\n", count);
-    return count;
+    printf("Loaded %d samples\n", data->rows);
+    return data->rows;
 }
 
-// Compute prediction (dot product of weights and features)
-double predict(const LinearModel *model, const double *features) {
-    double result = 0.0;
-    for (int i = 0; i < NUM_FEATURES; i++) {
-        result += model->weights[i] * features[i];
-    }
-    return result;
+// Predictions (dot product of weights and features) for every sample
+void predict(const LinearModel *model, const FeatureMatrix *data, double *out) {
+    mk_predict(data, model->weights, 0, data->rows, out);
 }
 
 // Mean Squared Error loss
-double compute_mse(const LinearModel *model, Instance *data, int data_size) {
-    double total_error = 0.0;
-    for (int i = 0; i < data_size; i++) {
-        double pred = predict(model, data[i].features);
-        double error = pred - data[i].label;
-        total_error += error * error;
-    }
-    return total_error / data_size;
+double compute_mse(const LinearModel *model, const FeatureMatrix *data) {
+    return mk_mse(data, model->weights, 0, data->rows);
 }
 
-// Train using gradient descent
-void train_model(LinearModel *model, Instance *train_data, int train_size, 
-                 int epochs, double learning_rate) {
+// Train using gradient descent. batch_size 0 (or >= the sample count) is
+// full-batch descent; otherwise the weights are updated after every
+// mini-batch. Gradients are split across the pool's threads.
+void train_model(LinearModel *model, const FeatureMatrix *train_data, MkPool *pool,
+                 int epochs, double learning_rate, int batch_size) {
+    int train_size = train_data->rows;
+    if (batch_size <= 0 || batch_size > train_size) {
+        batch_size = train_size;
+    }
+    
     // Initialize weights to small random values
     srand(time(NULL));
     for (int i = 0; i < NUM_FEATURES; i++) {
@@ -96,30 +125,24 @@ void train_model(LinearModel *model, Instance *train_data, int train_size,
     
     printf("\nTraining linear regression model (Matrix Format)...\n");
     printf("Epochs: %d, Learning rate: %.4f\n", epochs, learning_rate);
-    printf("Training samples: %d\n\n", train_size);
+    printf("Training samples: %d, batch size: %d\n", train_size, batch_size);
+    printf("Kernels: %s, threads: %d\n\n", mk_simd_name(), pool->threads);
     
     // Training loop
     for (int epoch = 0; epoch < epochs; epoch++) {
         double total_loss = 0.0;
         
-        // Batch gradient descent
-        double gradients[NUM_FEATURES] = {0};
-        
-        for (int i = 0; i < train_size; i++) {
-            double pred = predict(model, train_data[i].features);
-            double error = pred - train_data[i].label;
+        for (int first = 0; first < train_size; first += batch_size) {
+            int last = first + batch_size < train_size ? first + batch_size : train_size;
+            double gradients[NUM_FEATURES] = {0};
+            
+            // Loss and gradient of this batch in one pass
+            total_loss += mk_pool_gradient(pool, train_data, model->weights, first, last, gradients);
             
-            // Accumulate gradients
+            // Update weights
             for (int j = 0; j < NUM_FEATURES; j++) {
-                gradients[j] += error * train_data[i].features[j];
+                model->weights[j] -= learning_rate * gradients[j] / (last - first);
             }
-            
-            total_loss += error * error;
-        }
-        
-        // Update weights
-        for (int j = 0; j < NUM_FEATURES; j++) {
-            model->weights[j] -= learning_rate * gradients[j] / train_size;
         }
         
         // Print progress every 100 epochs
@@ -132,8 +155,117 @@ void train_model(LinearModel *model, Instance *train_data, int train_size,
     printf("\nTraining completed!\n");
 }
 
+// Train in closed form: one pass to accumulate X^T X and X^T y, then a
+// Cholesky solve (see normal_eq.h). ridge > 0 shrinks the board weights.
+int train_model_normal(LinearModel *model, const FeatureMatrix *train_data, double ridge) {
+    int train_size = train_data->rows;
+    NormalEq ne;
+    ne_init(&ne, NUM_FEATURES);
+    
+    printf("\nTraining linear regression model (Matrix Format, normal equation)...\n");
+    printf("Ridge: %.6f\n", ridge);
+    printf("Training samples: %d\n\n", train_size);
+    
+    for (int i = 0; i < train_size; i++) {
+        double row[NUM_FEATURES];
+        for (int j = 0; j < NUM_FEATURES; j++) {
+            row[j] = fm_col(train_data, j)[i];
+        }
+        ne_add(&ne, row, train_data->y[i]);
+    }
+    
+    if (!ne_solve(&ne, ridge, model->weights)) {
+        printf("Error: X^T X is singular; try --ridge with a small positive value\n");
+        return 0;
+    }
+    
+    printf("Training MSE = %.6f\n", ne_mse(&ne, model->weights));
+    printf("\nTraining completed!\n");
+    return 1;
+}
+
+// Wall-clock seconds (benchmark timing)
+static double wall_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+// Time each kernel over the whole training set (scalar and AVX2, plus the
+// threaded gradient) and print samples per second
+void benchmark_kernels(const LinearModel *model, const FeatureMatrix *data, MkPool *pool) {
+    int n = data->rows;
+    int reps = 2000000 / (n > 0 ? n : 1) + 1;
+    double *out = malloc(sizeof(double) * (n > 0 ? n : 1));
+    int use_simd = mk_simd();
+    volatile double sink = 0.0;
+    
+    if (!out) return;
+    
+    printf("\nKernel benchmark (%d samples x %d repetitions)\n", n, reps);
+    printf("  %-22s %16s\n", "Kernel", "Samples/sec");
+    
+    for (int simd = 0; simd <= 1; simd++) {
+        if (mk_set_simd(simd) != simd) {
+            printf("  (AVX2 not available on this CPU)\n");
+            break;
+        }
+        const char *name = mk_simd_name();
+        char label[64];
+        double t0, secs;
+        
+        t0 = wall_seconds();
+        for (int r = 0; r < reps; r++) {
+            mk_predict(data, model->weights, 0, n, out);
+            sink += out[r % n];
+        }
+        secs = wall_seconds() - t0;
+        snprintf(label, sizeof(label), "predict (%s)", name);
+        printf("  %-22s %16.0f\n", label, (double)n * reps / secs);
+        
+        t0 = wall_seconds();
+        for (int r = 0; r < reps; r++) {
+            sink += mk_mse(data, model->weights, 0, n);
+        }
+        secs = wall_seconds() - t0;
+        snprintf(label, sizeof(label), "mse (%s)", name);
+        printf("  %-22s %16.0f\n", label, (double)n * reps / secs);
+        
+        t0 = wall_seconds();
+        for (int r = 0; r < reps; r++) {
+            double grad[NUM_FEATURES] = {0};
+            sink += mk_gradient(data, model->weights, 0, n, grad);
+        }
+        secs = wall_seconds() - t0;
+        snprintf(label, sizeof(label), "gradient (%s)", name);
+        printf("  %-22s %16.0f\n", label, (double)n * reps / secs);
+        
+        if (pool->threads > 1) {
+            t0 = wall_seconds();
+            for (int r = 0; r < reps; r++) {
+                double grad[NUM_FEATURES] = {0};
+                sink += mk_pool_gradient(pool, data, model->weights, 0, n, grad);
+            }
+            secs = wall_seconds() - t0;
+            snprintf(label, sizeof(label), "gradient (%s, %dT)", name, pool->threads);
+            printf("  %-22s %16.0f\n", label, (double)n * reps / secs);
+        }
+    }
+    
+    mk_set_simd(use_simd);
+    free(out);
+}
+
 // Evaluate model on test set
-double evaluate_model(const LinearModel *model, Instance *test_data, int test_size) {
+double evaluate_model(const LinearModel *model, const FeatureMatrix *test_data) {
+    int test_size = test_data->rows;
     int correct = 0;
     int total = test_size;
     
@@ -142,10 +274,16 @@ double evaluate_model(const LinearModel *model, Instance *test_data, int test_si
     // Confusion matrix
     int tp = 0, tn = 0, fp = 0, fn = 0;
     
+    double *pred_value = malloc(sizeof(double) * (test_size > 0 ? test_size : 1));
+    if (!pred_value) {
+        printf("Error: Out of memory\n");
+        return 0.0;
+    }
+    predict(model, test_data, pred_value);
+    
     for (int i = 0; i < test_size; i++) {
-        double pred_value = predict(model, test_data[i].features);
-        int predicted = (pred_value > 0.0) ? 1 : -1;
-        int actual = (int)test_data[i].label;
+        int predicted = (pred_value[i] > 0.0) ? 1 : -1;
+        int actual = (int)test_data->y[i];
         
         if (predicted == actual) {
             correct++;
@@ -156,6 +294,7 @@ double evaluate_model(const LinearModel *model, Instance *test_data, int test_si
             else fn++;
         }
     }
+    free(pred_value);
     
     double accuracy = (double)correct / total * 100.0;
     
@@ -212,8 +351,8 @@ void save_model_binary(const LinearModel *model, const char *filename) {
 
 int main(int argc, char *argv[]) {
     LinearModel model;
-    Instance train_data[MAX_INSTANCES];
-    Instance test_data[MAX_INSTANCES];
+    FeatureMatrix train_data, test_data;
+    static MkPool pool;
     
     printf("========================================\n");
     printf("LINEAR REGRESSION - MATRIX FORMAT\n");
@@ -226,23 +365,62 @@ int main(int argc, char *argv[]) {
     const char *model_file = "linear_regression_model.txt";
     const char *model_bin = "linear_regression_model.bin";
     
-    // Allow custom file paths
-    if (argc > 1) {
-        train_file = argv[1];
+    int use_normal = 0;
+    double ridge = 0.0;
+    int batch_size = 0;
+    int threads = 1;
+    int bench = 0;
+    int positional = 0;
+    
+    // Allow custom file paths; options: --solver sgd|normal, --ridge L,
+    // --batch N, --threads T, --scalar, --bench
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--solver") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "normal") == 0) {
+                use_normal = 1;
+            } else if (strcmp(argv[i], "sgd") != 0) {
+                printf("Unknown solver '%s' (use sgd or normal)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--ridge") == 0 && i + 1 < argc) {
+            ridge = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scalar") == 0) {
+            mk_set_simd(0);
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            bench = 1;
+        } else if (positional == 0) {
+            train_file = argv[i];
+            positional++;
+        } else if (positional == 1) {
+            test_file = argv[i];
+            positional++;
+        } else {
+            printf("Usage: %s [train_file] [test_file] [--solver sgd|normal] [--ridge L]\n"
+                   "       [--batch N] [--threads T] [--scalar] [--bench]\n", argv[0]);
+            return 1;
+        }
     }
-    if (argc > 2) {
-        test_file = argv[2];
+    
+    if (!fm_init(&train_data, MAX_INSTANCES, NUM_FEATURES) ||
+        !fm_init(&test_data, MAX_INSTANCES, NUM_FEATURES)) {
+        printf("Error: Out of memory\n");
+        return 1;
     }
     
     // Load training data
-    int train_size = load_matrix_data(train_file, train_data);
+    int train_size = load_matrix_data(train_file, &train_data);
     if (train_size == 0) {
         printf("Error: No training data loaded\n");
         return 1;
     }
     
     // Load testing data
-    int test_size = load_matrix_data(test_file, test_data);
+    int test_size = load_matrix_data(test_file, &test_data);
     if (test_size == 0) {
         printf("Error: No testing data loaded\n");
         return 1;
@@ -252,11 +430,24 @@ int main(int argc, char *argv[]) {
     int epochs = 1000;
     double learning_rate = 0.01;
     
+    mk_pool_start(&pool, threads);
+    
     // Train model
-    train_model(&model, train_data, train_size, epochs, learning_rate);
+    if (use_normal) {
+        if (!train_model_normal(&model, &train_data, ridge)) {
+            return 1;
+        }
+    } else {
+        train_model(&model, &train_data, &pool, epochs, learning_rate, batch_size);
+    }
+    
+    if (bench) {
+        benchmark_kernels(&model, &train_data, &pool);
+    }
+    mk_pool_stop(&pool);
     
     // Evaluate model
-    double accuracy = evaluate_model(&model, test_data, test_size);
+    double accuracy = evaluate_model(&model, &test_data);
     
     // Save model
     save_model(&model, model_file);
@@ -272,5 +463,7 @@ int main(int argc, char *argv[]) {
     printf("                  %s\n", model_bin);
     printf("========================================\n");
     
+    fm_free(&train_data);
+    fm_free(&test_data);
     return 0;
 }
@@ -0,0 +1,434 @@
+// matrix_kernels.h - column-major feature storage and batch kernels for
+// the matrix-format trainers
+//
+// A FeatureMatrix keeps each feature as one contiguous column of doubles,
+// 32-byte aligned and zero-padded to a multiple of 4 rows, so kernels
+// stream a column 4 rows at a time instead of striding through per-sample
+// structs. Kernels over rows [first, last):
+//
+//   mk_predict   out[i - first] = w . x_i
+//   mk_mse       mean of (w . x_i - y_i)^2
+//   mk_gradient  grad += sum of (w . x_i - y_i) x_i; returns the summed
+//                squared error, so one pass gives both loss and gradient
+//
+// Each kernel has an AVX2/FMA version, used when the CPU supports it
+// (gcc on x86, checked once at run time), and a scalar fallback;
+// mk_set_simd(0) forces the fallback. An MkPool splits a gradient across
+// worker threads and adds their partial sums in thread order, so results
+// are reproducible for a given thread count.
+#ifndef MATRIX_KERNELS_H
+#define MATRIX_KERNELS_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MK_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define MK_HAVE_AVX2 0
+#endif
+
+#define MK_ALIGN 32
+#define MK_BLOCK 256        // rows per block; residuals are kept on the stack
+#define MK_MAX_COLS 32
+#define MK_MAX_THREADS 16
+
+typedef struct {
+    int rows;               // rows in use
+    int capacity;           // rows allocated
+    int cols;
+    int stride;             // doubles per column: capacity rounded up to 4
+    double *x;              // column j starts at x + j * stride
+    double *y;              // labels
+} FeatureMatrix;
+
+static inline void *mk_aligned_alloc(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, MK_ALIGN);
+#else
+    void *p = NULL;
+    return posix_memalign(&p, MK_ALIGN, size) == 0 ? p : NULL;
+#endif
+}
+
+static inline void mk_aligned_free(void *p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// Empty matrix with room for capacity rows; returns 0 if out of memory
+static inline int fm_init(FeatureMatrix *m, int capacity, int cols) {
+    memset(m, 0, sizeof(*m));
+    if (cols > MK_MAX_COLS) return 0;
+
+    m->capacity = capacity;
+    m->cols = cols;
+    m->stride = (capacity + 3) & ~3;
+    m->x = (double *)mk_aligned_alloc(sizeof(double) * (size_t)m->stride * cols);
+    m->y = (double *)mk_aligned_alloc(sizeof(double) * (size_t)m->stride);
+    if (!m->x || !m->y) {
+        mk_aligned_free(m->x);
+        mk_aligned_free(m->y);
+        memset(m, 0, sizeof(*m));
+        return 0;
+    }
+    memset(m->x, 0, sizeof(double) * (size_t)m->stride * cols);
+    memset(m->y, 0, sizeof(double) * (size_t)m->stride);
+    return 1;
+}
+
+static inline void fm_free(FeatureMatrix *m) {
+    mk_aligned_free(m->x);
+    mk_aligned_free(m->y);
+    memset(m, 0, sizeof(*m));
+}
+
+static inline double *fm_col(const FeatureMatrix *m, int j) {
+    return m->x + (size_t)j * m->stride;
+}
+
+// Append one sample (cols features); returns 0 when the matrix is full
+static inline int fm_add(FeatureMatrix *m, const double *features, double label) {
+    if (m->rows == m->capacity) return 0;
+    for (int j = 0; j < m->cols; j++) {
+        fm_col(m, j)[m->rows] = features[j];
+    }
+    m->y[m->rows++] = label;
+    return 1;
+}
+
+// ---------------------------------------------------------------------
+// Scalar kernels
+// ---------------------------------------------------------------------
+
+static inline void mk_predict_scalar(const FeatureMatrix *m, const double *w, int first, int n, double *out) {
+    for (int i = 0; i < n; i++) out[i] = 0.0;
+    for (int j = 0; j < m->cols; j++) {
+        const double *c = fm_col(m, j) + first;
+        double wj = w[j];
+        for (int i = 0; i < n; i++) out[i] += wj * c[i];
+    }
+}
+
+// Residuals of one block (n <= MK_BLOCK); returns their squared sum
+static inline double mk_residuals_scalar(const FeatureMatrix *m, const double *w, int first, int n, double *err) {
+    double sse = 0.0;
+    mk_predict_scalar(m, w, first, n, err);
+    for (int i = 0; i < n; i++) {
+        err[i] -= m->y[first + i];
+        sse += err[i] * err[i];
+    }
+    return sse;
+}
+
+static inline double mk_gradient_block_scalar(const FeatureMatrix *m, const double *w, int first, int n, double *grad) {
+    double err[MK_BLOCK];
+    double sse = mk_residuals_scalar(m, w, first, n, err);
+    int n4 = n & ~3;
+
+    // Four partial sums per column, so the adds do not form one long
+    // dependency chain
+    for (int j = 0; j < m->cols; j++) {
+        const double *c = fm_col(m, j) + first;
+        double g0 = 0.0, g1 = 0.0, g2 = 0.0, g3 = 0.0;
+        for (int i = 0; i < n4; i += 4) {
+            g0 += err[i] * c[i];
+            g1 += err[i + 1] * c[i + 1];
+            g2 += err[i + 2] * c[i + 2];
+            g3 += err[i + 3] * c[i + 3];
+        }
+        for (int i = n4; i < n; i++) g0 += err[i] * c[i];
+        grad[j] += (g0 + g1) + (g2 + g3);
+    }
+    return sse;
+}
+
+// ---------------------------------------------------------------------
+// AVX2 kernels (4 rows per instruction; tails fall back to scalar)
+// ---------------------------------------------------------------------
+
+#if MK_HAVE_AVX2
+__attribute__((target("avx2,fma")))
+static inline void mk_predict_avx2(const FeatureMatrix *m, const double *w, int first, int n, double *out) {
+    int n4 = n & ~3;
+    for (int i = 0; i < n4; i += 4) _mm256_storeu_pd(out + i, _mm256_setzero_pd());
+    for (int j = 0; j < m->cols; j++) {
+        const double *c = fm_col(m, j) + first;
+        __m256d wj = _mm256_set1_pd(w[j]);
+        for (int i = 0; i < n4; i += 4) {
+            __m256d acc = _mm256_loadu_pd(out + i);
+            _mm256_storeu_pd(out + i, _mm256_fmadd_pd(wj, _mm256_loadu_pd(c + i), acc));
+        }
+    }
+    if (n4 < n) mk_predict_scalar(m, w, first + n4, n - n4, out + n4);
+}
+
+__attribute__((target("avx2,fma")))
+static inline double mk_hsum_avx2(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v), hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+__attribute__((target("avx2,fma")))
+static inline double mk_residuals_avx2(const FeatureMatrix *m, const double *w, int first, int n, double *err) {
+    int n4 = n & ~3;
+    __m256d sse = _mm256_setzero_pd();
+    double tail = 0.0;
+
+    mk_predict_avx2(m, w, first, n, err);
+    for (int i = 0; i < n4; i += 4) {
+        __m256d e = _mm256_sub_pd(_mm256_loadu_pd(err + i), _mm256_loadu_pd(m->y + first + i));
+        _mm256_storeu_pd(err + i, e);
+        sse = _mm256_fmadd_pd(e, e, sse);
+    }
+    for (int i = n4; i < n; i++) {
+        err[i] -= m->y[first + i];
+        tail += err[i] * err[i];
+    }
+    return mk_hsum_avx2(sse) + tail;
+}
+
+__attribute__((target("avx2,fma")))
+static inline double mk_gradient_block_avx2(const FeatureMatrix *m, const double *w, int first, int n, double *grad) {
+    double err[MK_BLOCK];
+    double sse = mk_residuals_avx2(m, w, first, n, err);
+    int n4 = n & ~3, n8 = n & ~7;
+
+    for (int j = 0; j < m->cols; j++) {
+        const double *c = fm_col(m, j) + first;
+        __m256d g0 = _mm256_setzero_pd(), g1 = _mm256_setzero_pd();
+        double tail = 0.0;
+        for (int i = 0; i < n8; i += 8) {
+            g0 = _mm256_fmadd_pd(_mm256_loadu_pd(err + i), _mm256_loadu_pd(c + i), g0);
+            g1 = _mm256_fmadd_pd(_mm256_loadu_pd(err + i + 4), _mm256_loadu_pd(c + i + 4), g1);
+        }
+        if (n8 < n4) {
+            g0 = _mm256_fmadd_pd(_mm256_loadu_pd(err + n8), _mm256_loadu_pd(c + n8), g0);
+        }
+        for (int i = n4; i < n; i++) tail += err[i] * c[i];
+        grad[j] += mk_hsum_avx2(_mm256_add_pd(g0, g1)) + tail;
+    }
+    return sse;
+}
+#endif
+
+// ---------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------
+
+static int mk_simd_state = -1;   // -1 not checked yet, 0 scalar, 1 AVX2
+
+static inline int mk_simd(void) {
+    if (mk_simd_state < 0) {
+#if MK_HAVE_AVX2
+        __builtin_cpu_init();
+        mk_simd_state = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+        mk_simd_state = 0;
+#endif
+    }
+    return mk_simd_state;
+}
+
+// Ask for the AVX2 kernels (on) or the scalar ones; returns what is used
+static inline int mk_set_simd(int on) {
+    mk_simd_state = -1;
+    if (!on || !mk_simd()) mk_simd_state = 0;
+    return mk_simd_state;
+}
+
+static inline const char *mk_simd_name(void) {
+    return mk_simd() ? "AVX2" : "scalar";
+}
+
+static inline void mk_predict(const FeatureMatrix *m, const double *w, int first, int last, double *out) {
+    for (int i = first; i < last; i += MK_BLOCK) {
+        int n = last - i < MK_BLOCK ? last - i : MK_BLOCK;
+#if MK_HAVE_AVX2
+        if (mk_simd()) {
+            mk_predict_avx2(m, w, i, n, out + (i - first));
+            continue;
+        }
+#endif
+        mk_predict_scalar(m, w, i, n, out + (i - first));
+    }
+}
+
+static inline double mk_gradient(const FeatureMatrix *m, const double *w, int first, int last, double *grad) {
+    double sse = 0.0;
+    for (int i = first; i < last; i += MK_BLOCK) {
+        int n = last - i < MK_BLOCK ? last - i : MK_BLOCK;
+#if MK_HAVE_AVX2
+        if (mk_simd()) {
+            sse += mk_gradient_block_avx2(m, w, i, n, grad);
+            continue;
+        }
+#endif
+        sse += mk_gradient_block_scalar(m, w, i, n, grad);
+    }
+    return sse;
+}
+
+static inline double mk_mse(const FeatureMatrix *m, const double *w, int first, int last) {
+    double err[MK_BLOCK];
+    double sse = 0.0;
+
+    if (last <= first) return 0.0;
+    for (int i = first; i < last; i += MK_BLOCK) {
+        int n = last - i < MK_BLOCK ? last - i : MK_BLOCK;
+#if MK_HAVE_AVX2
+        if (mk_simd()) {
+            sse += mk_residuals_avx2(m, w, i, n, err);
+            continue;
+        }
+#endif
+        sse += mk_residuals_scalar(m, w, i, n, err);
+    }
+    return sse / (last - first);
+}
+
+// ---------------------------------------------------------------------
+// Thread pool for gradients: the caller takes slice 0, workers the rest
+// ---------------------------------------------------------------------
+
+typedef struct MkPool MkPool;
+
+typedef struct {
+    pthread_t thread;
+    MkPool *pool;
+    int index;
+    double grad[MK_MAX_COLS];
+    double sse;
+} MkWorker;
+
+struct MkPool {
+    int threads;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned generation;     // bumped for every job
+    int pending;             // workers still busy with the current job
+    int quit;
+
+    // Current job
+    const FeatureMatrix *m;
+    const double *w;
+    int first, last;
+
+    MkWorker worker[MK_MAX_THREADS];
+};
+
+// Rows of slice k out of the pool's threads, split on 4-row boundaries
+static inline void mk_pool_slice(const MkPool *pool, int k, int *first, int *last) {
+    int n = pool->last - pool->first;
+    int per = ((n / pool->threads) + 3) & ~3;
+    int a = pool->first + k * per;
+    int b = k == pool->threads - 1 ? pool->last : a + per;
+    *first = a < pool->last ? a : pool->last;
+    *last = b < pool->last ? b : pool->last;
+}
+
+static inline void mk_worker_run(MkWorker *wk) {
+    int first, last;
+    memset(wk->grad, 0, sizeof(wk->grad));
+    mk_pool_slice(wk->pool, wk->index, &first, &last);
+    wk->sse = mk_gradient(wk->pool->m, wk->pool->w, first, last, wk->grad);
+}
+
+static inline void *mk_worker_main(void *arg) {
+    MkWorker *wk = (MkWorker *)arg;
+    MkPool *pool = wk->pool;
+    unsigned seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->generation == seen && !pool->quit) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->quit) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        mk_worker_run(wk);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Start threads - 1 workers (1 = no workers, everything on the caller).
+// Returns the thread count actually available.
+static inline int mk_pool_start(MkPool *pool, int threads) {
+    memset(pool, 0, sizeof(*pool));
+    if (threads < 1) threads = 1;
+    if (threads > MK_MAX_THREADS) threads = MK_MAX_THREADS;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    pool->threads = 1;
+    for (int k = 1; k < threads; k++) {
+        pool->worker[k].pool = pool;
+        pool->worker[k].index = k;
+        if (pthread_create(&pool->worker[k].thread, NULL, mk_worker_main, &pool->worker[k]) != 0) break;
+        pool->threads++;
+    }
+    pool->worker[0].pool = pool;
+    return pool->threads;
+}
+
+static inline void mk_pool_stop(MkPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int k = 1; k < pool->threads; k++) {
+        pthread_join(pool->worker[k].thread, NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+}
+
+// mk_gradient over [first, last) split across the pool
+static inline double mk_pool_gradient(MkPool *pool, const FeatureMatrix *m, const double *w,
+                               int first, int last, double *grad) {
+    double sse = 0.0;
+
+    if (pool->threads == 1) return mk_gradient(m, w, first, last, grad);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->m = m;
+    pool->w = w;
+    pool->first = first;
+    pool->last = last;
+    pool->pending = pool->threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    mk_worker_run(&pool->worker[0]);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    // Reduce in thread order
+    for (int k = 0; k < pool->threads; k++) {
+        for (int j = 0; j < m->cols; j++) grad[j] += pool->worker[k].grad[j];
+        sse += pool->worker[k].sse;
+    }
+    return sse;
+}
+
+#endif // MATRIX_KERNELS_H
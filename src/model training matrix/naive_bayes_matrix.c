@@ -3,15 +3,17 @@
 #include <string.h>
 #include <math.h>
 
+#include "matrix_kernels.h"
+#include "../../TTTGUI/dataset_file.h"
+
 #define MAX_INSTANCES 10000
 #define NUM_FEATURES 9
 #define NUM_STATES 3
 #define NUM_CLASSES 2
 
-typedef struct {
-    double features[NUM_FEATURES];
-    int label;
-} Instance;
+// Matrix columns: 0 = constant 1, 1..9 = cell value v, 10..18 = v * v.
+// The log-odds of a sample is then one dot product (see predict).
+#define NUM_COLUMNS (1 + 2 * NUM_FEATURES)
 
 typedef struct {
     double feature_prob[NUM_FEATURES][NUM_STATES][NUM_CLASSES];
@@ -20,6 +22,7 @@ typedef struct {
     int class_count[NUM_CLASSES];
     int total_samples;
 } NaiveBayesModel;
+
 int feature_to_state(double feature) {
     if (feature > 0.5) return 0;      // x
     if (feature < -0.5) return 2;     // o
@@ -32,8 +35,46 @@ int label_to_class(int label) {
     return (label == 1) ? 0 : 1;
 }
 
-// Load matrix format data from file
-int load_matrix_data(const char *filename, Instance *data) {
+// Append one sample as the matrix columns (1, v, v * v)
+static void add_sample(FeatureMatrix *data, const double *f, int outcome) {
+    double row[NUM_COLUMNS];
+    row[0] = 1.0;
+    for (int i = 0; i < NUM_FEATURES; i++) {
+        row[1 + i] = f[i];
+        row[1 + NUM_FEATURES + i] = f[i] * f[i];
+    }
+    fm_add(data, row, (double)outcome);
+}
+
+// Load a packed binary dataset (dataset_file.h); draws count as lose,
+// as a 0 label does in the matrix format
+int load_binary_data(const char *filename, FeatureMatrix *data) {
+    int count;
+    DsRecord *records = ds_read(filename, &count);
+    if (!records) {
+        return 0;
+    }
+    
+    printf("Loading packed binary data from %s...\n", filename);
+    
+    data->rows = 0;
+    for (int i = 0; i < count && data->rows < data->capacity; i++) {
+        double f[NUM_FEATURES];
+        ds_record_features(&records[i], f);
+        add_sample(data, f, ds_label_value(records[i].label));
+    }
+    
+    free(records);
+    printf("Loaded %d samples\n", data->rows);
+    return data->rows;
+}
+
+// Load matrix format data from file (or packed binary, detected by its header)
+int load_matrix_data(const char *filename, FeatureMatrix *data) {
+    if (ds_is_binary_file(filename)) {
+        return load_binary_data(filename, data);
+    }
+    
     FILE *file = fopen(filename, "r");
     if (!file) {
         printf("Error opening file: %s\n", filename);
@@ -41,11 +82,11 @@ int load_matrix_data(const char *filename, Instance *data) {
     }
     
     char line[256];
-    int count = 0;
     
     printf("Loading matrix format data from %s...\n", filename);
     
-    while (fgets(line, sizeof(line), file) && count < MAX_INSTANCES) {
+    data->rows = 0;
+    while (fgets(line, sizeof(line), file) && data->rows < data->capacity) {
         if (line[0] == '#') {
             continue;
         }
@@ -68,16 +109,12 @@ int load_matrix_data(const char *filename, Instance *data) {
             continue;
         }
         
-        for (int i = 0; i < NUM_FEATURES; i++) {
-            data[count].features[i] = f[i];
-        }
-        data[count].label = outcome;
-        count++;
+        add_sample(data, f, outcome);
     }
     
     fclose(file);
-    printf("Loaded %d samples\n", count);
-    return count;
+    printf("Loaded %d samples\n", data->rows);
+    return data->rows;
 }
 
 // Initialize model
@@ -100,21 +137,24 @@ void init_model(NaiveBayesModel *model) {
 }
 
 // Train Naive Bayes model
-void train_model(NaiveBayesModel *model, Instance *train_data, int train_size) {
+void train_model(NaiveBayesModel *model, const FeatureMatrix *train_data) {
+    int train_size = train_data->rows;
+    
     printf("\nTraining Naive Bayes model (Matrix Format)...\n");
     printf("Training samples: %d\n\n", train_size);
     
     init_model(model);
     model->total_samples = train_size;
     
-    // Count occurrences
+    // Count occurrences, one feature column at a time
     for (int i = 0; i < train_size; i++) {
-        int class_idx = label_to_class(train_data[i].label);
-        model->class_count[class_idx]++;
-        
-        for (int f = 0; f < NUM_FEATURES; f++) {
-            int state_idx = feature_to_state(train_data[i].features[f]);
-            model->feature_count[f][state_idx][class_idx]++;
+        model->class_count[label_to_class((int)train_data->y[i])]++;
+    }
+    for (int f = 0; f < NUM_FEATURES; f++) {
+        const double *col = fm_col(train_data, 1 + f);
+        for (int i = 0; i < train_size; i++) {
+            int class_idx = label_to_class((int)train_data->y[i]);
+            model->feature_count[f][feature_to_state(col[i])][class_idx]++;
         }
     }
     
@@ -145,43 +185,65 @@ void train_model(NaiveBayesModel *model, Instance *train_data, int train_size) {
            model->class_count[1], model->class_prob[1] * 100.0);
 }
 
-// Predict class for a single instance
-int predict(NaiveBayesModel *model, double *features, double *confidence) {
-    double log_prob[NUM_CLASSES];
+// Log-odds weights: log P(win | x) - log P(lose | x) = w . row.
+// With cell value v in {1, 0, -1} (x, b, o) and L_s the per-state
+// log-likelihood ratio, L(v) = L_b + v (L_x - L_o) / 2 + v^2 ((L_x + L_o) / 2 - L_b),
+// which the v and v^2 columns pick out.
+void log_odds_weights(const NaiveBayesModel *model, double *w) {
+    w[0] = log(model->class_prob[0]) - log(model->class_prob[1]);
     
-    // Calculate log probabilities for numerical stability
-    for (int c = 0; c < NUM_CLASSES; c++) {
-        log_prob[c] = log(model->class_prob[c]);
-        
-        for (int f = 0; f < NUM_FEATURES; f++) {
-            int state_idx = feature_to_state(features[f]);
-            log_prob[c] += log(model->feature_prob[f][state_idx][c]);
+    for (int f = 0; f < NUM_FEATURES; f++) {
+        double l[NUM_STATES];
+        for (int s = 0; s < NUM_STATES; s++) {
+            l[s] = log(model->feature_prob[f][s][0]) - log(model->feature_prob[f][s][1]);
         }
+        w[0] += l[1];
+        w[1 + f] = (l[0] - l[2]) / 2.0;
+        w[1 + NUM_FEATURES + f] = (l[0] + l[2]) / 2.0 - l[1];
+    }
+}
+
+// Predict labels (+1 win, -1 lose) for every sample. confidence, if not
+// NULL, receives the probability of the predicted class.
+void predict(const NaiveBayesModel *model, const FeatureMatrix *data, int *labels, double *confidence) {
+    double w[NUM_COLUMNS];
+    double *score = malloc(sizeof(double) * (data->rows > 0 ? data->rows : 1));
+    
+    if (!score) {
+        for (int i = 0; i < data->rows; i++) labels[i] = -1;
+        return;
     }
     
-    // Find class with maximum probability
-    int best_class = (log_prob[0] > log_prob[1]) ? 0 : 1;
-    
-    // Convert log probabilities to probabilities for confidence
-    double max_log = (log_prob[0] > log_prob[1]) ? log_prob[0] : log_prob[1];
-    double sum_exp = exp(log_prob[0] - max_log) + exp(log_prob[1] - max_log);
-    *confidence = exp(log_prob[best_class] - max_log) / sum_exp;
+    log_odds_weights(model, w);
+    mk_predict(data, w, 0, data->rows, score);
     
-    // Convert class index back to label
-    return (best_class == 0) ? 1 : -1;
+    for (int i = 0; i < data->rows; i++) {
+        labels[i] = (score[i] > 0.0) ? 1 : -1;
+        if (confidence) {
+            confidence[i] = 1.0 / (1.0 + exp(-fabs(score[i])));
+        }
+    }
+    free(score);
 }
 
 // Evaluate model on test set
-double evaluate_model(NaiveBayesModel *model, Instance *test_data, int test_size) {
+double evaluate_model(NaiveBayesModel *model, const FeatureMatrix *test_data) {
+    int test_size = test_data->rows;
     int correct = 0;
     int tp = 0, tn = 0, fp = 0, fn = 0;
     
     printf("\nEvaluating model on test set (%d samples)...\n", test_size);
     
+    int *labels = malloc(sizeof(int) * (test_size > 0 ? test_size : 1));
+    if (!labels) {
+        printf("Error: Out of memory\n");
+        return 0.0;
+    }
+    predict(model, test_data, labels, NULL);
+    
     for (int i = 0; i < test_size; i++) {
-        double confidence;
-        int predicted = predict(model, test_data[i].features, &confidence);
-        int actual = test_data[i].label;
+        int predicted = labels[i];
+        int actual = (int)test_data->y[i];
         
         if (predicted == actual) {
             correct++;
@@ -192,6 +254,7 @@ double evaluate_model(NaiveBayesModel *model, Instance *test_data, int test_size
             else fn++;
         }
     }
+    free(labels);
     
     double accuracy = (double)correct / test_size * 100.0;
     
@@ -319,8 +382,7 @@ int load_model(NaiveBayesModel *model, const char *filename) {
 
 int main(int argc, char *argv[]) {
     NaiveBayesModel model;
-    Instance train_data[MAX_INSTANCES];
-    Instance test_data[MAX_INSTANCES];
+    FeatureMatrix train_data, test_data;
     
     printf("========================================\n");
     printf("NAIVE BAYES - MATRIX FORMAT\n");
@@ -341,25 +403,31 @@ int main(int argc, char *argv[]) {
         test_file = argv[2];
     }
     
+    if (!fm_init(&train_data, MAX_INSTANCES, NUM_COLUMNS) ||
+        !fm_init(&test_data, MAX_INSTANCES, NUM_COLUMNS)) {
+        printf("Error: Out of memory\n");
+        return 1;
+    }
+    
     // Load training data
-    int train_size = load_matrix_data(train_file, train_data);
+    int train_size = load_matrix_data(train_file, &train_data);
     if (train_size == 0) {
         printf("Error: No training data loaded\n");
         return 1;
     }
     
     // Load testing data
-    int test_size = load_matrix_data(test_file, test_data);
+    int test_size = load_matrix_data(test_file, &test_data);
     if (test_size == 0) {
         printf("Error: No testing data loaded\n");
         return 1;
     }
     
     // Train model
-    train_model(&model, train_data, train_size);
+    train_model(&model, &train_data);
     
     // Evaluate model
-    double accuracy = evaluate_model(&model, test_data, test_size);
+    double accuracy = evaluate_model(&model, &test_data);
     
     // Save model
     save_model(&model, model_file);
@@ -375,5 +443,7 @@ int main(int argc, char *argv[]) {
     printf("                  %s\n", model_bin);
     printf("========================================\n");
     
+    fm_free(&train_data);
+    fm_free(&test_data);
     return 0;
 }
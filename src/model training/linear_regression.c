@@ -4,6 +4,9 @@
 #include <math.h>
 #include <time.h>
 
+#include "normal_eq.h"
+#include "../../TTTGUI/dataset_file.h"
+
 #define MAX_INSTANCES 1000
 #define NUM_FEATURES 10  // 9 board positions + 1 bias term
 #define MAX_LINE_LENGTH 256
@@ -47,8 +50,33 @@ double encode_label(const char *label_str) {
     }
 }
 
-// Load data from file
+// Load a packed binary dataset (dataset_file.h)
+int load_data_binary(const char *filename, Instance *data) {
+    int count;
+    DsRecord *records = ds_read(filename, &count);
+    if (!records) {
+        return 0;
+    }
+    if (count > MAX_INSTANCES) {
+        count = MAX_INSTANCES;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        data[i].features[0] = 1.0;  // Bias term
+        ds_record_features(&records[i], &data[i].features[1]);
+        data[i].label = ds_label_value(records[i].label);
+    }
+    
+    free(records);
+    return count;
+}
+
+// Load data from file (CSV, or packed binary detected by its header)
 int load_data(const char *filename, Instance *data) {
+    if (ds_is_binary_file(filename)) {
+        return load_data_binary(filename, data);
+    }
+    
     FILE *file = fopen(filename, "r");
     if (!file) {
         printf("Error opening file: %s\n", filename);
@@ -128,6 +156,29 @@ void train_model(LinearModel *model, Instance *train_data, int train_size,
     printf("\nTraining complete!\n\n");
 }
 
+// Train in closed form: one pass to accumulate X^T X and X^T y, then a
+// Cholesky solve (see normal_eq.h). ridge > 0 shrinks the board weights.
+int train_model_normal(LinearModel *model, Instance *train_data, int train_size, double ridge) {
+    NormalEq ne;
+    ne_init(&ne, NUM_FEATURES);
+    
+    printf("Training linear regression model (normal equation)...\n");
+    printf("Ridge: %.6f\n\n", ridge);
+    
+    for (int i = 0; i < train_size; i++) {
+        ne_add(&ne, train_data[i].features, train_data[i].label);
+    }
+    
+    if (!ne_solve(&ne, ridge, model->weights)) {
+        printf("Error: X^T X is singular; try --ridge with a small positive value\n");
+        return 0;
+    }
+    
+    printf("Training MSE: %.6f\n", ne_mse(&ne, model->weights));
+    printf("\nTraining complete!\n\n");
+    return 1;
+}
+
 // Evaluate model on test set
 void evaluate_model(const LinearModel *model, Instance *test_data, int test_size) {
     int correct = 0;
@@ -237,7 +288,28 @@ void save_model_binary(const char *filename, const LinearModel *model) {
     printf("Model saved to %s (binary format)\n", filename);
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+    int use_normal = 0;
+    double ridge = 0.0;
+    
+    // Options: --solver sgd|normal, --ridge L (normal solver only)
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--solver") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "normal") == 0) {
+                use_normal = 1;
+            } else if (strcmp(argv[i], "sgd") != 0) {
+                printf("Unknown solver '%s' (use sgd or normal)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--ridge") == 0 && i + 1 < argc) {
+            ridge = atof(argv[++i]);
+        } else {
+            printf("Usage: %s [--solver sgd|normal] [--ridge L]\n", argv[0]);
+            return 1;
+        }
+    }
+    
     Instance train_data[MAX_INSTANCES];
     Instance test_data[MAX_INSTANCES];
     
@@ -264,7 +336,13 @@ int main() {
     int epochs = 1000;
     double learning_rate = 0.01;
     
-    train_model(&model, train_data, train_size, epochs, learning_rate);
+    if (use_normal) {
+        if (!train_model_normal(&model, train_data, train_size, ridge)) {
+            return 1;
+        }
+    } else {
+        train_model(&model, train_data, train_size, epochs, learning_rate);
+    }
     
     // Print learned weights
     printf("Learned weights:\n");
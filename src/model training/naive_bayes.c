@@ -2,36 +2,39 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
 
-#define MAX_FEATURES 9
-#define MAX_STATES 10
-#define MAX_LABELS 10
+#include "../../TTTGUI/nb_model.h"
+#include "../../TTTGUI/dataset_file.h"
+
+#define MAX_FEATURES NB_CELLS
 #define MAX_INSTANCES 1000
 #define MAX_LINE_LENGTH 256
 #define MAX_FEATURE_LENGTH 32
+#define DEFAULT_FOLDS 6
+#define MAX_FOLDS 64
 
 typedef struct {
     char features[MAX_FEATURES][MAX_FEATURE_LENGTH];
     char label[MAX_FEATURE_LENGTH];
 } Instance;
 
-typedef struct {
-    char state[MAX_FEATURE_LENGTH];
-    char label[MAX_FEATURE_LENGTH];
-    double probability;
-} FeatureProbability;
+// Compact model: label names once, P(state | label) by cell and state
+typedef NbModel Model;
 
+// Everything a model is built from. Counts add and subtract, so a
+// cross-validation fold is the full counts minus the fold's own.
 typedef struct {
-    char label[MAX_FEATURE_LENGTH];
-    double probability;
-} LabelProbability;
+    int samples;                                            // instances, skipped ones included
+    int label_counts[NB_MAX_LABELS];
+    int pair_counts[NB_MAX_LABELS][MAX_FEATURES][NB_CELL_STATES];
+} Counts;
 
+// An instance as a label index (-1 if unsupported) and NB_CELL_* codes
 typedef struct {
-    FeatureProbability feature_probs[MAX_FEATURES][MAX_STATES * MAX_LABELS];
-    int feature_count[MAX_FEATURES];
-    LabelProbability label_probs[MAX_LABELS];
-    int label_count;
-} Model;
+    int label;
+    unsigned char cells[MAX_FEATURES];
+} EncodedInstance;
 
 // Function to shuffle data
 void shuffle_data(Instance *data, int n) {
@@ -43,270 +46,319 @@ void shuffle_data(Instance *data, int n) {
     }
 }
 
-// Function to find or add label probability
-int find_label_index(Model *model, const char *label) {
-    for (int i = 0; i < model->label_count; i++) {
-        if (strcmp(model->label_probs[i].label, label) == 0) {
-            return i;
-        }
+// Features of an instance as NB_CELL_* codes (NB_CELL_STATES if unknown)
+static void instance_cells(const Instance *inst, unsigned char cells[MAX_FEATURES]) {
+    for (int j = 0; j < MAX_FEATURES; j++) {
+        cells[j] = (unsigned char)nb_cell_code(inst->features[j]);
     }
-    strcpy(model->label_probs[model->label_count].label, label);
-    model->label_probs[model->label_count].probability = 0.0;
-    return model->label_count++;
 }
 
-// Function to find or add feature probability
-int find_feature_prob_index(Model *model, int feature_idx, const char *state, const char *label) {
-    for (int i = 0; i < model->feature_count[feature_idx]; i++) {
-        if (strcmp(model->feature_probs[feature_idx][i].state, state) == 0 &&
-            strcmp(model->feature_probs[feature_idx][i].label, label) == 0) {
-            return i;
+// Add (sign 1) or remove (sign -1) one encoded instance
+static void count_instance(Counts *counts, const EncodedInstance *e, int sign) {
+    if (e->label < 0) {
+        return;
+    }
+    counts->label_counts[e->label] += sign;
+    for (int j = 0; j < MAX_FEATURES; j++) {
+        if (e->cells[j] < NB_CELL_STATES) {
+            counts->pair_counts[e->label][j][e->cells[j]] += sign;
         }
     }
-    strcpy(model->feature_probs[feature_idx][model->feature_count[feature_idx]].state, state);
-    strcpy(model->feature_probs[feature_idx][model->feature_count[feature_idx]].label, label);
-    model->feature_probs[feature_idx][model->feature_count[feature_idx]].probability = 0.0;
-    return model->feature_count[feature_idx]++;
 }
 
-// Learn function - trains the Naive Bayes model
-void learn(Instance *data, int data_size, Model *model) {
-    // Initialize model
-    model->label_count = 0;
-    for (int i = 0; i < MAX_FEATURES; i++) {
-        model->feature_count[i] = 0;
-    }
-    
-    // Count occurrences
-    for (int i = 0; i < data_size; i++) {
-        int label_idx = find_label_index(model, data[i].label);
-        model->label_probs[label_idx].probability += 1.0;
-        
+// Build a model from counts. Model label k is label order[k] of `names`.
+// P(state | label) is over the label's instances, P(label) over all.
+static void model_from_counts(const Counts *counts, const Model *names,
+                              const int *order, int label_count, Model *model) {
+    nb_init(model);
+    model->label_count = label_count;
+    
+    for (int k = 0; k < label_count; k++) {
+        int l = order[k];
+        strcpy(model->labels[k], names->labels[l]);
         for (int j = 0; j < MAX_FEATURES; j++) {
-            int feat_idx = find_feature_prob_index(model, j, data[i].features[j], data[i].label);
-            model->feature_probs[j][feat_idx].probability += 1.0;
-        }
-    }
-    
-    // Normalize feature probabilities
-    for (int i = 0; i < MAX_FEATURES; i++) {
-        for (int j = 0; j < model->feature_count[i]; j++) {
-            const char *label = model->feature_probs[i][j].label;
-            for (int k = 0; k < model->label_count; k++) {
-                if (strcmp(model->label_probs[k].label, label) == 0) {
-                    model->feature_probs[i][j].probability /= model->label_probs[k].probability;
-                    break;
+            for (int s = 0; s < NB_CELL_STATES; s++) {
+                if (counts->pair_counts[l][j][s] > 0) {
+                    nb_set(model, k, j, s, (double)counts->pair_counts[l][j][s] / counts->label_counts[l]);
                 }
             }
         }
+        model->prior[k] = (double)counts->label_counts[l] / counts->samples;
     }
+}
+
+// Encode instances and count them; label indices are interned into
+// `names` in order of first appearance. Returns 0 (after printing why)
+// if a label does not fit the model: more than NB_MAX_LABELS labels or
+// one NB_LABEL_LEN characters or longer.
+static int count_data(Instance *data, int data_size, Model *names,
+                      EncodedInstance *encoded, Counts *counts) {
+    nb_init(names);
+    memset(counts, 0, sizeof(*counts));
+    counts->samples = data_size;
     
-    // Normalize label probabilities
-    for (int i = 0; i < model->label_count; i++) {
-        model->label_probs[i].probability /= data_size;
+    for (int i = 0; i < data_size; i++) {
+        encoded[i].label = nb_intern_label(names, data[i].label);
+        if (encoded[i].label < 0) {
+            printf("Error: label '%s' of instance %d does not fit the model "
+                   "(at most %d labels of %d characters)\n",
+                   data[i].label, i + 1, NB_MAX_LABELS, NB_LABEL_LEN - 1);
+            return 0;
+        }
+        instance_cells(&data[i], encoded[i].cells);
+        count_instance(counts, &encoded[i], 1);
     }
+    return 1;
+}
+
+// Learn function - trains the Naive Bayes model; 0 if the labels do not fit
+int learn(Instance *data, int data_size, Model *model) {
+    static EncodedInstance encoded[MAX_INSTANCES];
+    Model names;
+    Counts counts;
+    int order[NB_MAX_LABELS];
+    
+    if (!count_data(data, data_size, &names, encoded, &counts)) {
+        return 0;
+    }
+    for (int l = 0; l < names.label_count; l++) {
+        order[l] = l;
+    }
+    model_from_counts(&counts, &names, order, names.label_count, model);
+    return 1;
 }
 
 // Predict function - predicts the label for a new instance
 void predict(Model *model, char features[MAX_FEATURES][MAX_FEATURE_LENGTH], 
              char *best_label, double *best_prob) {
-    double max_prob = -1.0;
+    unsigned char cells[MAX_FEATURES];
     
-    for (int i = 0; i < model->label_count; i++) {
-        double prob = model->label_probs[i].probability;
-        
-        for (int j = 0; j < MAX_FEATURES; j++) {
-            for (int k = 0; k < model->feature_count[j]; k++) {
-                if (strcmp(model->feature_probs[j][k].state, features[j]) == 0 &&
-                    strcmp(model->feature_probs[j][k].label, model->label_probs[i].label) == 0) {
-                    prob *= model->feature_probs[j][k].probability;
-                    break;
-                }
-            }
-        }
-        
-        if (prob > max_prob) {
-            max_prob = prob;
-            strcpy(best_label, model->label_probs[i].label);
-        }
+    for (int j = 0; j < MAX_FEATURES; j++) {
+        cells[j] = (unsigned char)nb_cell_code(features[j]);
     }
     
-    *best_prob = max_prob;
+    // Pairs never seen in training leave the product unchanged
+    int label = nb_predict_label(model, cells, 1.0, best_prob);
+    if (label >= 0) {
+        strcpy(best_label, model->labels[label]);
+    }
 }
 
-// Save model to binary file
+// Save model to binary file (nb_model.h header + compact struct)
 int saveModelBinary(const char *filename, Model *model) {
-    FILE *fp = fopen(filename, "wb");
-    if (!fp) {
+    if (!nb_save_binary(filename, model)) {
         printf("Error: Could not create file %s\n", filename);
         return 0;
     }
     
-    // Write the entire model struct to file
-    fwrite(model, sizeof(Model), 1, fp);
-    fclose(fp);
-    
     printf("Model saved to %s (binary format)\n", filename);
     return 1;
 }
 
-// Load model from binary file
+// Load model from binary file; also reads the raw struct dumps older
+// builds of this program wrote
 int loadModelBinary(const char *filename, Model *model) {
-    FILE *fp = fopen(filename, "rb");
-    if (!fp) {
-        printf("Error: Could not open file %s\n", filename);
+    if (!nb_load_binary(filename, model)) {
+        printf("Error: Could not load binary model %s\n", filename);
         return 0;
     }
     
-    // Read the model struct from file
-    fread(model, sizeof(Model), 1, fp);
-    fclose(fp);
-    
     printf("Model loaded from %s (binary format)\n", filename);
     return 1;
 }
 
 // Save model to human-readable text file
 int saveModelText(const char *filename, Model *model) {
-    FILE *fp = fopen(filename, "w");
-    if (!fp) {
+    if (!nb_save_text(filename, model)) {
         printf("Error: Could not create file %s\n", filename);
         return 0;
     }
     
-    fprintf(fp, "========================================\n");
-    fprintf(fp, "NAIVE BAYES MODEL\n");
-    fprintf(fp, "========================================\n\n");
-    
-    fprintf(fp, "LABEL PROBABILITIES\n");
-    fprintf(fp, "----------------------------------------\n");
-    fprintf(fp, "Total labels: %d\n\n", model->label_count);
-    for (int i = 0; i < model->label_count; i++) {
-        fprintf(fp, "Label: %-10s P(Label) = %.6f\n", 
-                model->label_probs[i].label, 
-                model->label_probs[i].probability);
+    printf("Model saved to %s (text format)\n", filename);
+    return 1;
+}
+
+// Load model from text file
+int loadModelText(const char *filename, Model *model) {
+    if (!nb_load_text(filename, model)) {
+        printf("Error: Could not load text model %s\n", filename);
+        return 0;
     }
     
-    fprintf(fp, "\n\nFEATURE PROBABILITIES\n");
-    fprintf(fp, "========================================\n");
-    
-    for (int i = 0; i < MAX_FEATURES; i++) {
-        if (model->feature_count[i] == 0) continue;
-        
-        fprintf(fp, "\nFeature %d: (%d unique state-label pairs)\n", 
-                i, model->feature_count[i]);
-        fprintf(fp, "----------------------------------------\n");
+    printf("Model loaded from %s (text format)\n", filename);
+    return 1;
+}
+
+// Shared state of one cross-validation run
+typedef struct {
+    const EncodedInstance *encoded;
+    int data_size;
+    const Counts *counts;        // all instances
+    const Model *names;
+    int first_seen[NB_MAX_LABELS];
+    int folds;
+    int part_size;
+    double *accuracy;
+} CrossValidation;
+
+typedef struct {
+    const CrossValidation *cv;
+    int first_fold;
+    int fold_step;
+} CrossValidationWorker;
+
+// Train on everything outside [test_start, test_end) by subtracting the
+// fold from the full counts, then score the fold
+static double evaluate_fold(const CrossValidation *cv, int test_start, int test_end) {
+    Counts counts = *cv->counts;
+    int order[NB_MAX_LABELS] = {0}, first[NB_MAX_LABELS], label_count = 0;
+    
+    for (int i = test_start; i < test_end; i++) {
+        count_instance(&counts, &cv->encoded[i], -1);
+    }
+    counts.samples -= test_end - test_start;
+    
+    // Keep the label order learn() would give the remaining instances
+    // (first appearance), since the first label wins probability ties
+    for (int l = 0; l < cv->names->label_count; l++) {
+        int pos = cv->first_seen[l];
+        if (pos >= test_start && pos < test_end) {
+            pos = -1;
+            for (int i = test_end; i < cv->data_size; i++) {
+                if (cv->encoded[i].label == l) {
+                    pos = i;
+                    break;
+                }
+            }
+        }
+        if (pos < 0) {
+            continue;
+        }
         
-        for (int j = 0; j < model->feature_count[i]; j++) {
-            fprintf(fp, "  State=%-5s | Label=%-10s | P(State|Label) = %.6f\n",
-                    model->feature_probs[i][j].state,
-                    model->feature_probs[i][j].label,
-                    model->feature_probs[i][j].probability);
+        int k = label_count++;
+        while (k > 0 && first[k - 1] > pos) {
+            first[k] = first[k - 1];
+            order[k] = order[k - 1];
+            k--;
         }
+        first[k] = pos;
+        order[k] = l;
     }
     
-    fprintf(fp, "\n========================================\n");
-    fprintf(fp, "END OF MODEL\n");
-    fprintf(fp, "========================================\n");
+    Model model;
+    model_from_counts(&counts, cv->names, order, label_count, &model);
     
-    fclose(fp);
-    printf("Model saved to %s (text format)\n", filename);
-    return 1;
+    // Pairs never seen in training leave the product unchanged
+    int correct = 0;
+    for (int i = test_start; i < test_end; i++) {
+        int k = nb_predict_label(&model, cv->encoded[i].cells, 1.0, NULL);
+        if (k >= 0 && cv->encoded[i].label == order[k]) {
+            correct++;
+        }
+    }
+    return (double)correct / cv->part_size;
 }
 
-// Load model from text file
-int loadModelText(const char *filename, Model *model) {
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
-        printf("Error: Could not open file %s\n", filename);
+static void *cross_validation_worker(void *arg) {
+    CrossValidationWorker *worker = (CrossValidationWorker *)arg;
+    const CrossValidation *cv = worker->cv;
+    
+    for (int fold = worker->first_fold; fold < cv->folds; fold += worker->fold_step) {
+        cv->accuracy[fold] = evaluate_fold(cv, fold * cv->part_size, (fold + 1) * cv->part_size);
+    }
+    return NULL;
+}
+
+// k-fold cross-validation: instances are counted once and each fold's
+// model is those counts minus the fold's, so the whole run costs about one
+// training pass plus one prediction pass. Folds are spread over `threads`
+// threads; fold f tests on instances [f * n / k, (f + 1) * n / k) and any
+// remainder always stays in training. Returns 0 if the labels do not fit.
+int cross_validate(Instance *data, int data_size, int folds, int threads, double *accuracy) {
+    static EncodedInstance encoded[MAX_INSTANCES];
+    Model names;
+    Counts counts;
+    CrossValidation cv;
+    CrossValidationWorker workers[MAX_FOLDS];
+    pthread_t handles[MAX_FOLDS];
+    int started[MAX_FOLDS] = {0};
+    
+    if (!count_data(data, data_size, &names, encoded, &counts)) {
         return 0;
     }
     
-    char line[256];
-    model->label_count = 0;
-    for (int i = 0; i < MAX_FEATURES; i++) {
-        model->feature_count[i] = 0;
+    cv.encoded = encoded;
+    cv.data_size = data_size;
+    cv.counts = &counts;
+    cv.names = &names;
+    cv.folds = folds;
+    cv.part_size = data_size / folds;
+    cv.accuracy = accuracy;
+    for (int l = 0; l < names.label_count; l++) {
+        cv.first_seen[l] = -1;
     }
-    
-    // Skip header lines until we find "Total labels:"
-    while (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, "Total labels:") != NULL) {
-            sscanf(line, "Total labels: %d", &model->label_count);
-            fgets(line, sizeof(line), fp); // Skip blank line
-            break;
+    for (int i = data_size - 1; i >= 0; i--) {
+        if (encoded[i].label >= 0) {
+            cv.first_seen[encoded[i].label] = i;
         }
     }
     
-    // Read label probabilities
-    for (int i = 0; i < model->label_count; i++) {
-        if (fgets(line, sizeof(line), fp)) {
-            sscanf(line, "Label: %s P(Label) = %lf", 
-                   model->label_probs[i].label, 
-                   &model->label_probs[i].probability);
-        }
+    if (threads > folds) threads = folds;
+    if (threads < 1) threads = 1;
+    
+    for (int t = 0; t < threads; t++) {
+        workers[t].cv = &cv;
+        workers[t].first_fold = t;
+        workers[t].fold_step = threads;
     }
     
-    // Read feature probabilities
-    int current_feature = -1;
-    while (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, "Feature") != NULL && strstr(line, ":") != NULL) {
-            int count;
-            sscanf(line, "Feature %d: (%d unique", &current_feature, &count);
-            model->feature_count[current_feature] = 0;
-        } else if (strstr(line, "State=") != NULL && current_feature >= 0) {
-            int idx = model->feature_count[current_feature];
-            sscanf(line, "  State=%s | Label=%s | P(State|Label) = %lf",
-                   model->feature_probs[current_feature][idx].state,
-                   model->feature_probs[current_feature][idx].label,
-                   &model->feature_probs[current_feature][idx].probability);
-            model->feature_count[current_feature]++;
+    // Thread 0 runs on the caller; a worker that cannot be started also
+    // runs here
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&handles[t], NULL, cross_validation_worker, &workers[t]) == 0;
+    }
+    cross_validation_worker(&workers[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(handles[t], NULL);
+        } else {
+            cross_validation_worker(&workers[t]);
         }
     }
-    
-    fclose(fp);
-    printf("Model loaded from %s (text format)\n", filename);
     return 1;
 }
 
-// Cross-validation function
-void cross_validate(Instance *data, int data_size, double *accuracy) {
-    int part_size = data_size / 6;
+// Load a packed binary dataset (dataset_file.h)
+int load_data_binary(const char *filename, Instance *data) {
+    int count;
+    DsRecord *records = ds_read(filename, &count);
+    if (!records) {
+        return 0;
+    }
+    if (count > MAX_INSTANCES) {
+        count = MAX_INSTANCES;
+    }
     
-    for (int fold = 0; fold < 6; fold++) {
-        int test_start = fold * part_size;
-        int test_end = (fold + 1) * part_size;
-        
-        // Create train set
-        Instance train[MAX_INSTANCES];
-        int train_size = 0;
-        for (int i = 0; i < data_size; i++) {
-            if (i < test_start || i >= test_end) {
-                train[train_size++] = data[i];
-            }
-        }
-        
-        // Train model
-        Model model;
-        learn(train, train_size, &model);
-        
-        // Test model
-        int correct = 0;
-        for (int i = test_start; i < test_end; i++) {
-            char predicted_label[MAX_FEATURE_LENGTH];
-            double prob;
-            predict(&model, data[i].features, predicted_label, &prob);
-            
-            if (strcmp(predicted_label, data[i].label) == 0) {
-                correct++;
-            }
+    for (int i = 0; i < count; i++) {
+        char cells[MAX_FEATURES];
+        ds_record_cells(&records[i], cells);
+        for (int j = 0; j < MAX_FEATURES; j++) {
+            data[i].features[j][0] = cells[j];
+            data[i].features[j][1] = '\0';
         }
-        
-        accuracy[fold] = (double)correct / part_size;
+        strcpy(data[i].label, ds_label_name(records[i].label));
     }
+    
+    free(records);
+    return count;
 }
 
-// Load data from file
+// Load data from file (CSV, or packed binary detected by its header)
 int load_data(const char *filename, Instance *data) {
+    if (ds_is_binary_file(filename)) {
+        return load_data_binary(filename, data);
+    }
+    
     FILE *file = fopen(filename, "r");
     if (!file) {
         printf("Error opening file: %s\n", filename);
@@ -339,9 +391,31 @@ int load_data(const char *filename, Instance *data) {
     return count;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     srand(time(NULL));
     
+    int folds = DEFAULT_FOLDS;
+    int threads = 0;             // 0 = one per fold
+    
+    // Options: --folds K, --threads T
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--folds") == 0 && i + 1 < argc) {
+            folds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            printf("Usage: %s [--folds K] [--threads T]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (folds < 2 || folds > MAX_FOLDS) {
+        printf("Folds must be between 2 and %d\n", MAX_FOLDS);
+        return 1;
+    }
+    if (threads <= 0) {
+        threads = folds;
+    }
+    
     Instance train_data[MAX_INSTANCES];
     Instance test_data[MAX_INSTANCES];
     
@@ -364,7 +438,9 @@ int main() {
     // Train model
     printf("\nTraining model...\n");
     Model model;
-    learn(train_data, train_size, &model);
+    if (!learn(train_data, train_size, &model)) {
+        return 1;
+    }
     printf("Training complete!\n");
     
     // Save model in both formats
@@ -375,7 +451,7 @@ int main() {
     // Print label probabilities
     printf("\nLabel probabilities:\n");
     for (int i = 0; i < model.label_count; i++) {
-        printf("  %s: %.4f\n", model.label_probs[i].label, model.label_probs[i].probability);
+        printf("  %s: %.4f\n", model.labels[i], model.prior[i]);
     }
     
     // Test on test data
@@ -402,16 +478,22 @@ int main() {
     printf("\nTest Accuracy: %.4f (%d/%d correct)\n", test_accuracy, correct, test_size);
     
     // Cross-validation on training data
-    printf("\nPerforming 6-fold cross-validation on training data:\n");
-    double accuracy[6];
-    cross_validate(train_data, train_size, accuracy);
-    
-    double sum = 0.0;
-    for (int i = 0; i < 6; i++) {
-        printf("  Fold %d: %.4f\n", i + 1, accuracy[i]);
-        sum += accuracy[i];
+    if (train_size < folds) {
+        printf("\nSkipping cross-validation: %d instances for %d folds\n", train_size, folds);
+    } else {
+        printf("\nPerforming %d-fold cross-validation on training data:\n", folds);
+        double accuracy[MAX_FOLDS];
+        if (!cross_validate(train_data, train_size, folds, threads, accuracy)) {
+            return 1;
+        }
+        
+        double sum = 0.0;
+        for (int i = 0; i < folds; i++) {
+            printf("  Fold %d: %.4f\n", i + 1, accuracy[i]);
+            sum += accuracy[i];
+        }
+        printf("Average CV Accuracy: %.4f\n", sum / folds);
     }
-    printf("Average CV Accuracy: %.4f\n", sum / 6);
     
     // Demonstrate loading model from file
     printf("\n========================================\n");
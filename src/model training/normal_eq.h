@@ -0,0 +1,111 @@
+// normal_eq.h - closed-form least squares for the linear regression trainers
+//
+// Accumulates X^T X and X^T y one sample at a time (one pass over the
+// data, no sample storage), then solves
+//
+//     (X^T X / n + ridge * I') w = X^T y / n
+//
+// by Cholesky factorisation. I' is the identity without its first
+// diagonal entry, so feature 0 (the bias) is never penalised. ridge = 0
+// is ordinary least squares; the result depends only on the data, not
+// on a seed or a learning rate.
+#ifndef NORMAL_EQ_H
+#define NORMAL_EQ_H
+
+#include <math.h>
+#include <string.h>
+
+#define NE_MAX_DIM 16
+
+typedef struct {
+    int dim;                            // features per sample, bias included
+    long samples;
+    double xtx[NE_MAX_DIM][NE_MAX_DIM]; // upper triangle only
+    double xty[NE_MAX_DIM];
+    double yy;                          // sum of y^2, for the training MSE
+} NormalEq;
+
+static inline void ne_init(NormalEq *ne, int dim) {
+    memset(ne, 0, sizeof(*ne));
+    ne->dim = dim;
+}
+
+static inline void ne_add(NormalEq *ne, const double *x, double y) {
+    for (int i = 0; i < ne->dim; i++) {
+        for (int j = i; j < ne->dim; j++)
+            ne->xtx[i][j] += x[i] * x[j];
+        ne->xty[i] += x[i] * y;
+    }
+    ne->yy += y * y;
+    ne->samples++;
+}
+
+// Solve for w (ne->dim weights). Returns 1 on success, 0 if there are
+// no samples or the system is not positive definite (collinear
+// features with ridge = 0); w is left untouched then.
+static inline int ne_solve(const NormalEq *ne, double ridge, double *w) {
+    double a[NE_MAX_DIM][NE_MAX_DIM], z[NE_MAX_DIM];
+    int n = ne->dim;
+
+    if (ne->samples == 0)
+        return 0;
+
+    // Lower triangle of the scaled, regularised matrix
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j <= i; j++)
+            a[i][j] = ne->xtx[j][i] / (double)ne->samples;
+        if (i > 0)
+            a[i][i] += ridge;
+    }
+
+    // In-place Cholesky: a = L L^T
+    for (int j = 0; j < n; j++) {
+        double d = a[j][j];
+        for (int k = 0; k < j; k++)
+            d -= a[j][k] * a[j][k];
+        if (d <= 1e-12 * (a[j][j] > 1.0 ? a[j][j] : 1.0))
+            return 0;
+        a[j][j] = sqrt(d);
+
+        for (int i = j + 1; i < n; i++) {
+            double s = a[i][j];
+            for (int k = 0; k < j; k++)
+                s -= a[i][k] * a[j][k];
+            a[i][j] = s / a[j][j];
+        }
+    }
+
+    // L z = X^T y / n, then L^T w = z
+    for (int i = 0; i < n; i++) {
+        double s = ne->xty[i] / (double)ne->samples;
+        for (int k = 0; k < i; k++)
+            s -= a[i][k] * z[k];
+        z[i] = s / a[i][i];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        double s = z[i];
+        for (int k = i + 1; k < n; k++)
+            s -= a[k][i] * w[k];
+        w[i] = s / a[i][i];
+    }
+    return 1;
+}
+
+// Training MSE of w from the accumulated sums (no second pass):
+// (y^T y - 2 w^T X^T y + w^T X^T X w) / n
+static inline double ne_mse(const NormalEq *ne, const double *w) {
+    double sse = ne->yy;
+
+    if (ne->samples == 0)
+        return 0.0;
+    for (int i = 0; i < ne->dim; i++) {
+        sse -= 2.0 * w[i] * ne->xty[i];
+        for (int j = 0; j < ne->dim; j++) {
+            double g = i <= j ? ne->xtx[i][j] : ne->xtx[j][i];
+            sse += w[i] * g * w[j];
+        }
+    }
+    return sse > 0.0 ? sse / (double)ne->samples : 0.0;
+}
+
+#endif // NORMAL_EQ_H
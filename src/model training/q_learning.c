@@ -5,9 +5,12 @@
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include "../../TTTGUI/search.h"
+#include "../../TTTGUI/qtable.h"
+#include "../../TTTGUI/opponent.h"
+#include "../../TTTGUI/dataset_file.h"
 
 #define BOARD_SIZE 9
-#define Q_TABLE_SIZE 20000
 #define MAX_EPISODES 100000
 #define EMPTY 'b'
 #define PLAYER_X 'x'
@@ -20,26 +23,16 @@
 #define EPSILON_END 0.05
 #define EPSILON_DECAY 0.9999
 
+// Episodes played in lockstep by train_q_learning() (divides the
+// 5000-episode report interval)
+#define BATCH_SIZE 100
+
 // Rewards
 #define REWARD_WIN 1.0
 #define REWARD_DRAW 0.5
 #define REWARD_LOSE -1.0
 #define REWARD_STEP -0.01
 
-// Structure for Q-table entry
-typedef struct QEntry {
-    char board[BOARD_SIZE];
-    int action;
-    double q_value;
-    int visits;
-    struct QEntry *next;
-} QEntry;
-
-typedef struct {
-    QEntry *table[Q_TABLE_SIZE];
-    int total_entries;
-} QTable;
-
 typedef struct {
     char board[BOARD_SIZE];
     int game_over;
@@ -48,8 +41,6 @@ typedef struct {
 
 // Forward declarations
 void init_qtable(QTable *qt);
-void free_qtable(QTable *qt);
-unsigned long hash_board(char board[BOARD_SIZE]);
 double get_q_value(QTable *qt, char board[BOARD_SIZE], int action);
 void update_q_value(QTable *qt, char board[BOARD_SIZE], int action, double value);
 void init_board(GameState *game);
@@ -63,132 +54,54 @@ void save_qtable(const char *filename, QTable *qt);
 void test_against_random(QTable *qt, int test_games);
 void test_against_minimax(QTable *qt, int test_games);
 void print_board(char board[BOARD_SIZE]);
-int minimax_move(char board[BOARD_SIZE], char player, int depth_limit);
 int minimax_eval(char board[BOARD_SIZE], char player, int depth, int is_maximizing, int depth_limit);
 void load_dataset_with_minimax_init(const char *filename, QTable *qt);
 
-// Minimax implementation
-int eval_board(char board[BOARD_SIZE], char player) {
-    char winner = check_winner(board);
-    if (winner == player) return 10;
-    if (winner != ' ' && winner != 'd') return -10;
-    return 0;
-}
+// Minimax implementation: the alpha-beta kernel and transposition table shared with the GUI,
+// with flat +/-10 scores (depth_bias 0) as this trainer always used
+static SearchStats minimax_stats = {0, 0};
 
-int minimax_eval(char board[BOARD_SIZE], char player, int depth, int is_maximizing, int depth_limit) {
-    char winner = check_winner(board);
-    if (winner != ' ' || depth == depth_limit) {
-        return eval_board(board, player);
-    }
+static int minimax_eval_bb(uint16_t me, uint16_t opp, int depth, int is_maximizing, int depth_limit) {
+    SearchContext ctx;
     
-    char current_player = is_maximizing ? player : (player == PLAYER_O ? PLAYER_X : PLAYER_O);
-    int valid_moves[BOARD_SIZE];
-    int num_moves = get_valid_moves(board, valid_moves);
+    search_init(&ctx, depth_limit, 0);
+    ctx.tt = tt_shared();
+    int score = search_value(&ctx, me, opp, is_maximizing, depth);
     
-    if (is_maximizing) {
-        int max_eval = -1000;
-        for (int i = 0; i < num_moves; i++) {
-            board[valid_moves[i]] = current_player;
-            int eval = minimax_eval(board, player, depth + 1, 0, depth_limit);
-            board[valid_moves[i]] = EMPTY;
-            if (eval > max_eval) max_eval = eval;
-        }
-        return max_eval;
-    } else {
-        int min_eval = 1000;
-        for (int i = 0; i < num_moves; i++) {
-            board[valid_moves[i]] = current_player;
-            int eval = minimax_eval(board, player, depth + 1, 1, depth_limit);
-            board[valid_moves[i]] = EMPTY;
-            if (eval < min_eval) min_eval = eval;
-        }
-        return min_eval;
-    }
+    minimax_stats.nodes += ctx.stats.nodes;
+    minimax_stats.cutoffs += ctx.stats.cutoffs;
+    return score;
 }
 
-int minimax_move(char board[BOARD_SIZE], char player, int depth_limit) {
-    int valid_moves[BOARD_SIZE];
-    int num_moves = get_valid_moves(board, valid_moves);
-    if (num_moves == 0) return -1;
-    
-    int best_move = valid_moves[0];
-    int best_eval = -1000;
-    
-    for (int i = 0; i < num_moves; i++) {
-        board[valid_moves[i]] = player;
-        int eval = minimax_eval(board, player, 0, 0, depth_limit);
-        board[valid_moves[i]] = EMPTY;
-        
-        if (eval > best_eval) {
-            best_eval = eval;
-            best_move = valid_moves[i];
-        }
-    }
+int minimax_eval(char board[BOARD_SIZE], char player, int depth, int is_maximizing, int depth_limit) {
+    Bitboard bb = bb_from_chars(board);
+    uint16_t me = (player == PLAYER_X) ? bb.x : bb.o;
+    uint16_t opp = (player == PLAYER_X) ? bb.o : bb.x;
     
-    return best_move;
+    return minimax_eval_bb(me, opp, depth, is_maximizing, depth_limit);
 }
 
-void init_qtable(QTable *qt) {
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        qt->table[i] = NULL;
-    }
-    qt->total_entries = 0;
-}
+// X's policies, one cached move table per kind (opponent.h); each board
+// is searched once and then shared by every episode and the test games
+static OpponentPolicy opponents[OPP_KINDS];
+static OpponentKind train_opponent = OPP_DEPTH4;
 
-void free_qtable(QTable *qt) {
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        QEntry *entry = qt->table[i];
-        while (entry != NULL) {
-            QEntry *temp = entry;
-            entry = entry->next;
-            free(temp);
-        }
-    }
+static int opponent_move(OpponentKind kind, uint16_t x, uint16_t o) {
+    Bitboard bb = {x, o};
+    // Only the random policy draws, so the others leave rand()'s sequence alone
+    return opp_move(&opponents[kind], bb, kind == OPP_RANDOM ? (unsigned)rand() : 0);
 }
 
-unsigned long hash_board(char board[BOARD_SIZE]) {
-    unsigned long hash = 5381;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        hash = ((hash << 5) + hash) + board[i];
-    }
-    return hash % Q_TABLE_SIZE;
+void init_qtable(QTable *qt) {
+    qt_init(qt);
 }
 
 double get_q_value(QTable *qt, char board[BOARD_SIZE], int action) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = qt->table[hash];
-    
-    while (entry != NULL) {
-        if (entry->action == action && memcmp(entry->board, board, BOARD_SIZE) == 0) {
-            return entry->q_value;
-        }
-        entry = entry->next;
-    }
-    
-    return 0.0;
+    return qt_value(qt, qt_state(board), action);
 }
 
 void update_q_value(QTable *qt, char board[BOARD_SIZE], int action, double value) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = qt->table[hash];
-    
-    while (entry != NULL) {
-        if (entry->action == action && memcmp(entry->board, board, BOARD_SIZE) == 0) {
-            entry->q_value = value;
-            entry->visits++;
-            return;
-        }
-        entry = entry->next;
-    }
-    
-    QEntry *new_entry = (QEntry *)malloc(sizeof(QEntry));
-    memcpy(new_entry->board, board, BOARD_SIZE);
-    new_entry->action = action;
-    new_entry->q_value = value;
-    new_entry->visits = 1;
-    new_entry->next = qt->table[hash];
-    qt->table[hash] = new_entry;
-    qt->total_entries++;
+    qt_update_value(qt, qt_state(board), action, (float)value);
 }
 
 void init_board(GameState *game) {
@@ -241,18 +154,9 @@ int choose_action_epsilon_greedy(QTable *qt, char board[BOARD_SIZE], char player
         return valid_moves[rand() % num_moves];
     }
     
-    int best_action = valid_moves[0];
-    double best_q = get_q_value(qt, board, best_action);
-    
-    for (int i = 1; i < num_moves; i++) {
-        double q = get_q_value(qt, board, valid_moves[i]);
-        if (q > best_q) {
-            best_q = q;
-            best_action = valid_moves[i];
-        }
-    }
-    
-    return best_action;
+    // Every move's value sits in one row of the table
+    Bitboard bb = bb_from_chars(board);
+    return qt_best_move(qt, bb_index(bb), bb_empty(bb));
 }
 
 int choose_best_action(QTable *qt, char board[BOARD_SIZE], char player) {
@@ -260,24 +164,47 @@ int choose_best_action(QTable *qt, char board[BOARD_SIZE], char player) {
 }
 
 double get_max_q_value(QTable *qt, char board[BOARD_SIZE], char player) {
-    int valid_moves[BOARD_SIZE];
-    int num_moves = get_valid_moves(board, valid_moves);
-    
-    if (num_moves == 0) return 0.0;
+    Bitboard bb = bb_from_chars(board);
+    return qt_best_value(qt, bb_index(bb), bb_empty(bb));
+}
+
+// Initialise every move O can make from board with its Minimax value;
+// returns the number of moves initialised
+static int init_moves_with_minimax(QTable *qt, char board[BOARD_SIZE]) {
+    int moves_initialized = 0;
     
-    double max_q = get_q_value(qt, board, valid_moves[0]);
-    for (int i = 1; i < num_moves; i++) {
-        double q = get_q_value(qt, board, valid_moves[i]);
-        if (q > max_q) max_q = q;
+    // For each empty position, evaluate the move with Minimax
+    for (int pos = 0; pos < BOARD_SIZE; pos++) {
+        if (board[pos] == EMPTY) {
+            // Try making this move as O
+            board[pos] = PLAYER_O;
+            
+            // Evaluate resulting position with Minimax (depth 4 = balanced quality/speed)
+            int minimax_score = minimax_eval(board, PLAYER_O, 0, 0, 4);
+            
+            // Restore board
+            board[pos] = EMPTY;
+            
+            // Convert minimax score (-10 to +10) to Q-value range (-1.0 to +1.0)
+            // Scale down and add small noise to avoid exact ties
+            double init_q = (minimax_score / 15.0) + ((rand() / (double)RAND_MAX) * 0.05 - 0.025);
+            
+            // Initialize this state-action pair
+            update_q_value(qt, board, pos, init_q);
+            moves_initialized++;
+        }
     }
-    
-    return max_q;
+    return moves_initialized;
 }
 
-// PROPER dataset initialization - evaluates each move individually
+// PROPER dataset initialization - evaluates each move individually.
+// Accepts CSV or a packed binary dataset (dataset_file.h).
 void load_dataset_with_minimax_init(const char *filename, QTable *qt) {
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
+    int packed = ds_is_binary_file(filename);
+    int record_count = 0;
+    DsRecord *records = packed ? ds_read(filename, &record_count) : NULL;
+    FILE *fp = packed ? NULL : fopen(filename, "r");
+    if (packed ? !records : !fp) {
         printf("Warning: Could not load dataset from %s\n", filename);
         printf("Starting with zero-initialized Q-values.\n");
         return;
@@ -294,7 +221,19 @@ void load_dataset_with_minimax_init(const char *filename, QTable *qt) {
     int boards_processed = 0;
     int moves_initialized = 0;
     
-    while (fgets(line, sizeof(line), fp) != NULL) {
+    for (int r = 0; r < record_count; r++) {
+        char board[BOARD_SIZE];
+        ds_record_cells(&records[r], board);
+        boards_processed++;
+        moves_initialized += init_moves_with_minimax(qt, board);
+        
+        if (boards_processed % 500 == 0) {
+            printf("  Processed %d boards, initialized %d moves...\r", boards_processed, moves_initialized);
+            fflush(stdout);
+        }
+    }
+    
+    while (fp && fgets(line, sizeof(line), fp) != NULL) {
         line[strcspn(line, "\n")] = 0;
         if (strlen(line) == 0) continue;
         
@@ -313,28 +252,7 @@ void load_dataset_with_minimax_init(const char *filename, QTable *qt) {
         if (token != NULL && i == BOARD_SIZE) {
             strcpy(outcome, token);
             boards_processed++;
-            
-            // For each empty position, evaluate the move with Minimax
-            for (int pos = 0; pos < BOARD_SIZE; pos++) {
-                if (board[pos] == EMPTY) {
-                    // Try making this move as O
-                    board[pos] = PLAYER_O;
-                    
-                    // Evaluate resulting position with Minimax (depth 4 = balanced quality/speed)
-                    int minimax_score = minimax_eval(board, PLAYER_O, 0, 0, 4);
-                    
-                    // Restore board
-                    board[pos] = EMPTY;
-                    
-                    // Convert minimax score (-10 to +10) to Q-value range (-1.0 to +1.0)
-                    // Scale down and add small noise to avoid exact ties
-                    double init_q = (minimax_score / 15.0) + ((rand() / (double)RAND_MAX) * 0.05 - 0.025);
-                    
-                    // Initialize this state-action pair
-                    update_q_value(qt, board, pos, init_q);
-                    moves_initialized++;
-                }
-            }
+            moves_initialized += init_moves_with_minimax(qt, board);
         }
         
         if (boards_processed % 500 == 0 && boards_processed > 0) {
@@ -343,7 +261,8 @@ void load_dataset_with_minimax_init(const char *filename, QTable *qt) {
         }
     }
     
-    fclose(fp);
+    if (fp) fclose(fp);
+    free(records);
     printf("\n\n✓ Dataset initialization complete!\n");
     printf("  Boards processed: %d\n", boards_processed);
     printf("  Moves initialized: %d\n", moves_initialized);
@@ -351,103 +270,198 @@ void load_dataset_with_minimax_init(const char *filename, QTable *qt) {
     printf("  Average moves per board: %.1f\n\n", (double)moves_initialized / boards_processed);
 }
 
-void train_q_learning(QTable *qt, int episodes) {
-    printf("========================================\n");
-    printf("Q-LEARNING TRAINING (With Dataset Init)\n");
-    printf("========================================\n");
-    printf("Episodes: %d\n", episodes);
-    printf("Alpha: %.3f, Gamma: %.3f\n", ALPHA, GAMMA);
-    printf("Epsilon: %.2f → %.2f\n", EPSILON_START, EPSILON_END);
-    printf("Training O against Minimax (depth 2)\n");
-    printf("========================================\n\n");
+// BATCH_SIZE games as struct-of-arrays bitboards. Each step runs one
+// short loop over the whole batch, and O's moves are kept as table rows
+// and row cells (qt_key) for the TD pass at the end.
+typedef struct {
+    int n;                                   // games in this batch
+    uint16_t x[BATCH_SIZE];
+    uint16_t o[BATCH_SIZE];
+    uint8_t live[BATCH_SIZE];                // 1 while the game is running
+    char winner[BATCH_SIZE];                 // PLAYER_X, PLAYER_O or 'd'
+    double epsilon[BATCH_SIZE];
+    int16_t states[BATCH_SIZE][5];           // rows of the boards O moved from
+    uint16_t empties[BATCH_SIZE][5];         // their empty cells, in row cells
+    int8_t actions[BATCH_SIZE][5];           // O's moves, in row cells
+    uint8_t num_moves[BATCH_SIZE];
+} BatchEnv;
+
+static int mask_base3[1 << BOARD_SIZE];      // sum of 3^i over set bits i
+
+static void init_mask_base3(void) {
+    for (int m = 0; m < (1 << BOARD_SIZE); m++) {
+        int v = 0;
+        for (int i = BOARD_SIZE - 1; i >= 0; i--) {
+            v = v * 3 + ((m >> i) & 1);
+        }
+        mask_base3[m] = v;
+    }
+}
+
+// Branch-free win test, so the batch loop below vectorizes
+static inline uint8_t mask_has_win(uint16_t m) {
+    uint8_t w = 0;
+    for (int k = 0; k < 8; k++) {
+        w |= (uint8_t)((m & BB_WIN_MASKS[k]) == BB_WIN_MASKS[k]);
+    }
+    return w;
+}
+
+// After `mover` played in every live game: end the games it won or filled
+static void batch_check(BatchEnv *env, char mover) {
+    const uint16_t *side = (mover == PLAYER_X) ? env->x : env->o;
+    uint8_t won[BATCH_SIZE], full[BATCH_SIZE];
+    
+    for (int g = 0; g < env->n; g++) {
+        won[g] = mask_has_win(side[g]);
+        full[g] = (uint8_t)((env->x[g] | env->o[g]) == BB_FULL);
+    }
     
-    int wins = 0, losses = 0, draws = 0;
-    double epsilon = EPSILON_START;
+    for (int g = 0; g < env->n; g++) {
+        if (!env->live[g]) continue;
+        if (won[g]) {
+            env->live[g] = 0;
+            env->winner[g] = mover;
+        } else if (full[g]) {
+            env->live[g] = 0;
+            env->winner[g] = 'd';
+        }
+    }
+}
+
+// Play every game of the batch to the end: X is the training opponent, O
+// is epsilon-greedy on the Q-table. Returns the number of O moves made.
+static int batch_play(BatchEnv *env, QTable *qt) {
+    int o_moves = 0;
+    int any_live = 1;
+    
+    for (int g = 0; g < env->n; g++) {
+        env->x[g] = env->o[g] = 0;
+        env->live[g] = 1;
+        env->winner[g] = 'd';
+        env->num_moves[g] = 0;
+    }
     
-    for (int episode = 0; episode < episodes; episode++) {
-        GameState game;
-        init_board(&game);
-        
-        typedef struct {
-            char board[BOARD_SIZE];
-            int action;
-            double reward;
-        } Transition;
-        
-        Transition transitions[10];
-        int num_transitions = 0;
-        
-        char player = PLAYER_X;
+    while (any_live) {
+        // X to move
+        for (int g = 0; g < env->n; g++) {
+            if (!env->live[g]) continue;
+            int cell = opponent_move(train_opponent, env->x[g], env->o[g]);
+            env->x[g] |= (uint16_t)(1u << cell);
+        }
+        batch_check(env, PLAYER_X);
         
-        while (!game.game_over) {
-            int action;
+        // O to move
+        any_live = 0;
+        for (int g = 0; g < env->n; g++) {
+            if (!env->live[g]) continue;
             
-            if (player == PLAYER_O) {
-                action = choose_action_epsilon_greedy(qt, game.board, PLAYER_O, epsilon);
-                
-                if (action != -1) {
-                    memcpy(transitions[num_transitions].board, game.board, BOARD_SIZE);
-                    transitions[num_transitions].action = action;
-                    transitions[num_transitions].reward = REWARD_STEP;
-                    num_transitions++;
-                }
-            } else {
-                action = minimax_move(game.board, PLAYER_X, 4);
-            }
-            
-            if (action == -1) break;
+            uint16_t empty = (uint16_t)(~(env->x[g] | env->o[g]) & BB_FULL);
+            int state = mask_base3[env->x[g]] + 2 * mask_base3[env->o[g]];
+            QtKey key = qt_key(qt, state);
+            int cell;
             
-            game.board[action] = player;
-            
-            char winner = check_winner(game.board);
-            if (winner != ' ') {
-                game.game_over = 1;
-                game.winner = winner;
-                
-                if (winner == PLAYER_O) wins++;
-                else if (winner == PLAYER_X) losses++;
-                else draws++;
+            if ((double)rand() / RAND_MAX < env->epsilon[g]) {
+                int skip = rand() % bb_popcount(empty);
+                unsigned m = empty;
+                while (skip-- > 0) m &= m - 1;
+                cell = bb_first(m);
+            } else {
+                cell = qt_best_move(qt, state, empty);
             }
             
-            player = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
+            int k = env->num_moves[g]++;
+            env->states[g][k] = (int16_t)key.state;
+            env->empties[g][k] = (uint16_t)qt_key_moves(key, empty);
+            env->actions[g][k] = (int8_t)qt_key_action(key, cell);
+            env->o[g] |= (uint16_t)(1u << cell);
+            o_moves++;
         }
+        batch_check(env, PLAYER_O);
         
-        double final_reward = (game.winner == PLAYER_O) ? REWARD_WIN :
-                             (game.winner == PLAYER_X) ? REWARD_LOSE : REWARD_DRAW;
+        for (int g = 0; g < env->n; g++) {
+            any_live |= env->live[g];
+        }
+    }
+    
+    return o_moves;
+}
+
+// TD updates for the whole batch, game by game, last move first
+static void batch_update(const BatchEnv *env, QTable *qt) {
+    for (int g = 0; g < env->n; g++) {
+        double final_reward = (env->winner[g] == PLAYER_O) ? REWARD_WIN :
+                              (env->winner[g] == PLAYER_X) ? REWARD_LOSE : REWARD_DRAW;
+        int last = env->num_moves[g] - 1;
         
-        for (int i = num_transitions - 1; i >= 0; i--) {
-            char current_board[BOARD_SIZE];
-            memcpy(current_board, transitions[i].board, BOARD_SIZE);
-            int action = transitions[i].action;
-            
-            double old_q = get_q_value(qt, current_board, action);
+        for (int i = last; i >= 0; i--) {
+            int state = env->states[g][i];
+            int action = env->actions[g][i];
+            double old_q = qt->q[state][action];
             double new_q;
             
-            if (i == num_transitions - 1) {
+            if (i == last) {
                 new_q = old_q + ALPHA * (final_reward - old_q);
             } else {
-                char next_board[BOARD_SIZE];
-                memcpy(next_board, transitions[i + 1].board, BOARD_SIZE);
-                
-                double max_next_q = get_max_q_value(qt, next_board, PLAYER_O);
-                double immediate_reward = transitions[i].reward;
-                new_q = old_q + ALPHA * (immediate_reward + GAMMA * max_next_q - old_q);
+                double max_next_q = qt_max_q(qt, env->states[g][i + 1], env->empties[g][i + 1]);
+                new_q = old_q + ALPHA * (REWARD_STEP + GAMMA * max_next_q - old_q);
             }
             
-            update_q_value(qt, current_board, action, new_q);
+            qt_update(qt, state, action, (float)new_q);
+        }
+    }
+}
+
+void train_q_learning(QTable *qt, int episodes) {
+    printf("========================================\n");
+    printf("Q-LEARNING TRAINING (With Dataset Init)\n");
+    printf("========================================\n");
+    printf("Episodes: %d (batches of %d)\n", episodes, BATCH_SIZE);
+    printf("Alpha: %.3f, Gamma: %.3f\n", ALPHA, GAMMA);
+    printf("Epsilon: %.2f → %.2f\n", EPSILON_START, EPSILON_END);
+    printf("Training O against the %s opponent\n", OPP_NAMES[train_opponent]);
+    printf("========================================\n\n");
+    
+    static BatchEnv env;
+    int wins = 0, losses = 0, draws = 0;
+    clock_t start = clock();
+    
+    init_mask_base3();
+    
+    for (int first = 0; first < episodes; first += BATCH_SIZE) {
+        env.n = (episodes - first < BATCH_SIZE) ? episodes - first : BATCH_SIZE;
+        
+        // Each game keeps the epsilon its episode number would have had
+        for (int g = 0; g < env.n; g++) {
+            int episode = first + g;
+            env.epsilon[g] = (episode == 0) ? EPSILON_START :
+                EPSILON_END + (EPSILON_START - EPSILON_END) * exp(-(episode - 1) / (episodes / 5.0));
         }
         
-        epsilon = EPSILON_END + (EPSILON_START - EPSILON_END) * exp(-episode / (episodes / 5.0));
+        batch_play(&env, qt);
+        batch_update(&env, qt);
+        
+        for (int g = 0; g < env.n; g++) {
+            if (env.winner[g] == PLAYER_O) wins++;
+            else if (env.winner[g] == PLAYER_X) losses++;
+            else draws++;
+        }
         
-        if ((episode + 1) % 5000 == 0) {
+        int done = first + env.n;
+        if (done % 5000 == 0) {
+            double epsilon = EPSILON_END + (EPSILON_START - EPSILON_END) * exp(-(done - 1) / (episodes / 5.0));
             printf("Episode %6d | W: %4d (%.1f%%) D: %4d (%.1f%%) L: %4d (%.1f%%) | ε: %.3f | Q-entries: %d\n",
-                   episode + 1, wins, (wins * 100.0) / 5000, draws, (draws * 100.0) / 5000,
+                   done, wins, (wins * 100.0) / 5000, draws, (draws * 100.0) / 5000,
                    losses, (losses * 100.0) / 5000, epsilon, qt->total_entries);
             wins = losses = draws = 0;
         }
     }
     
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
     printf("\n✓ Training complete! Total Q-entries: %d\n", qt->total_entries);
+    if (seconds > 0.0) {
+        printf("  Training time: %.2fs (%.0f episodes/sec)\n", seconds, episodes / seconds);
+    }
 }
 
 void print_board(char board[BOARD_SIZE]) {
@@ -526,7 +540,8 @@ void test_against_minimax(QTable *qt, int test_games) {
             if (player == PLAYER_O) {
                 action = choose_best_action(qt, game.board, PLAYER_O);
             } else {
-                action = minimax_move(game.board, PLAYER_X, 4);
+                Bitboard bb = bb_from_chars(game.board);
+                action = opponent_move(OPP_DEPTH4, bb.x, bb.o);
             }
             
             if (action == -1) break;
@@ -559,17 +574,22 @@ void save_qtable(const char *filename, QTable *qt) {
     
     fprintf(fp, "# Q-Learning Model (Dataset-Initialized)\n");
     fprintf(fp, "# Format: board_state,action,q_value,visits\n");
-    fprintf(fp, "# Total entries: %d\n\n", qt->total_entries);
+    fprintf(fp, "# Total entries: %d\n", qt->total_entries);
+    if (qt->symmetric) fprintf(fp, "%s\n", QT_SYMMETRIC_TAG);
+    fprintf(fp, "\n");
     
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        QEntry *entry = qt->table[i];
-        while (entry != NULL) {
+    for (int state = 0; state < BB_STATES; state++) {
+        if (!qt->present[state]) continue;
+        
+        char board[BOARD_SIZE];
+        qt_board(state, board);
+        for (int action = 0; action < BOARD_SIZE; action++) {
+            if (!qt_has(qt, state, action)) continue;
             for (int j = 0; j < BOARD_SIZE; j++) {
-                fprintf(fp, "%c", entry->board[j]);
+                fprintf(fp, "%c", board[j]);
                 if (j < BOARD_SIZE - 1) fprintf(fp, ",");
             }
-            fprintf(fp, ",%d,%.6f,%d\n", entry->action, entry->q_value, entry->visits);
-            entry = entry->next;
+            fprintf(fp, ",%d,%.6f,%d\n", action, qt->q[state][action], qt->visits[state][action]);
         }
     }
     
@@ -584,9 +604,38 @@ int main(int argc, char *argv[]) {
     printf("Q-LEARNING WITH DATASET INITIALIZATION\n");
     printf("========================================\n\n");
     
-    QTable qtable;
+    static QTable qtable;   // ~1.4 MB, too big for the stack
     init_qtable(&qtable);
     
+    // -s / --symmetric: one set of values for all 8 rotations/reflections
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--symmetric") == 0) {
+            qt_set_symmetric(&qtable, 1);
+            for (int j = i; j < argc - 1; j++) argv[j] = argv[j + 1];
+            argc--;
+            break;
+        }
+    }
+    if (qtable.symmetric) {
+        printf("Symmetry-reduced Q-table (canonical boards only)\n\n");
+    }
+    
+    // --opponent NAME: X's policy during training (random, depth2, depth4, perfect)
+    for (int k = 0; k < OPP_KINDS; k++) opp_init(&opponents[k], (OpponentKind)k);
+    for (int i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], "--opponent") == 0) {
+            int kind = opp_parse(argv[i + 1]);
+            if (kind < 0) {
+                fprintf(stderr, "Unknown opponent: %s (random, depth2, depth4, perfect)\n", argv[i + 1]);
+                return 1;
+            }
+            train_opponent = (OpponentKind)kind;
+            for (int j = i; j < argc - 2; j++) argv[j] = argv[j + 2];
+            argc -= 2;
+            break;
+        }
+    }
+    
     // Determine dataset file
     char dataset_file[256];
     if (argc > 2) {
@@ -611,6 +660,14 @@ int main(int argc, char *argv[]) {
     test_against_random(&qtable, 1000);
     test_against_minimax(&qtable, 100);
     
+    printf("\nMinimax search: %lu nodes, %lu cutoffs\n",
+           minimax_stats.nodes, minimax_stats.cutoffs);
+    for (int k = 0; k < OPP_KINDS; k++) {
+        if (opponents[k].solved == 0) continue;
+        printf("Opponent %s: %d boards cached (%lu nodes searched)\n",
+               OPP_NAMES[k], opponents[k].solved, opponents[k].stats.nodes);
+    }
+    
     // Save
     printf("\nSaving model...\n");
     save_qtable("q_learning_with_dataset.txt", &qtable);
@@ -623,6 +680,5 @@ int main(int argc, char *argv[]) {
     printf("\nCompare this with q_learning_fixed.txt to see\n");
     printf("if dataset initialization helps or hurts!\n");
     
-    free_qtable(&qtable);
     return 0;
 }
@@ -2,7 +2,6 @@
 #define FROZEN_Q_MODEL_H
 
 #define BOARD_SIZE 9
-#define Q_TABLE_SIZE 20000
 
 typedef struct FrozenQModel FrozenQModel;
 
@@ -4,9 +4,18 @@
 #include <time.h>
 #include <math.h>
 #include <signal.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "../../TTTGUI/search.h"
+#include "../../TTTGUI/opponent.h"
+#include "../../TTTGUI/qtable_file.h"
+#include "../../TTTGUI/dataset_file.h"
 
 #define BOARD_SIZE 9
-#define Q_TABLE_SIZE 20000
 #define EMPTY 'b'
 #define PLAYER_X 'x'
 #define PLAYER_O 'o'
@@ -14,7 +23,8 @@
 typedef enum {
     MODE_FROM_SCRATCH,
     MODE_DATASET_INIT,
-    MODE_RESUME
+    MODE_RESUME,
+    MODE_SOLVE
 } TrainingMode;
 
 #define ALPHA 0.3
@@ -24,24 +34,12 @@ typedef enum {
 
 #define CHECKPOINT_INTERVAL 1000
 #define STATS_INTERVAL 100
+#define MAX_THREADS 64
 
 #define REWARD_WIN 1.0
 #define REWARD_DRAW 0.5
 #define REWARD_LOSE -1.0
 
-typedef struct QEntry {
-    char board[BOARD_SIZE];
-    int action;
-    double q_value;
-    int visits;
-    struct QEntry *next;
-} QEntry;
-
-typedef struct {
-    QEntry *table[Q_TABLE_SIZE];
-    int total_entries;
-} QTable;
-
 typedef struct {
     int total_episodes;
     int x_wins;
@@ -55,61 +53,131 @@ typedef struct {
 volatile sig_atomic_t keep_running = 1;
 QTable global_qtable_o;
 TrainingStats global_stats;
+static int use_symmetry = 0;   // -s: canonical boards only
+
+// Training runs on worker threads that share global_qtable_o without locks
+// (Hogwild): table reads and writes go through the qt_*_shared() helpers,
+// counters in global_stats are updated atomically.
+typedef struct {
+    int id;
+    pthread_t thread;
+    TransTable *tt;          // own minimax table; tt_shared() is not thread-safe
+    double epsilon_start;
+    int max_episodes;        // 0 = until interrupted
+} Worker;
+
+static int episodes_claimed = 0;
+
+// Checkpoints are written by a background thread. A worker that reaches
+// CHECKPOINT_INTERVAL only raises checkpoint_pending; the writer copies
+// the shared table and saves the copy while training goes on. Requests
+// that arrive during a save are merged into the next one.
+typedef struct {
+    int saved;
+    int full;                // of saved: complete snapshots
+    int failed;
+    int merged;              // requests folded into an already pending one
+    double last_ms;          // copy + write of the last checkpoint
+    double last_copy_ms;     // the copy part of it
+    double total_ms;
+    int last_records;        // (row, action) records in the last checkpoint
+    int log_records;         // records in the delta log since the last full one
+} CheckpointStats;
+
+static pthread_mutex_t checkpoint_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t checkpoint_cond = PTHREAD_COND_INITIALIZER;
+static int checkpoint_pending = 0;
+static int checkpoint_quit = 0;
+static CheckpointStats checkpoint_stats;   // guarded by checkpoint_lock
+static QTable checkpoint_table;            // snapshot written by checkpoints
+
+// Delta checkpoints. update_q_value() marks changed (row, action) pairs in
+// dirty_moves; most checkpoints append only those records to <output>.delta
+// and end the batch with "# end <sequence>". A full checkpoint (compaction)
+// rewrites the model with its sequence number and deletes the log, and
+// load_qtable() replays complete batches newer than the model.
+#define COMPACT_EVERY 20          // at most this many checkpoints between full ones
+#define DELTA_SUFFIX ".delta"
+
+typedef struct {
+    int16_t state;
+    int8_t action;
+    float q;
+    int visits;
+} DeltaRecord;
+
+static uint16_t dirty_moves[BB_STATES];   // per row: actions changed since the last checkpoint
+static unsigned checkpoint_sequence = 0;  // last checkpoint written or loaded
+static DeltaRecord delta_buffer[BB_STATES * BOARD_SIZE];   // writer thread only
+
+// Per-thread state; the main thread (dataset init) keeps the defaults
+static _Thread_local unsigned thread_rng = 2463534242u;
+static _Thread_local TransTable *thread_tt = NULL;   // NULL = tt_shared()
+static _Thread_local SearchStats thread_search = {0, 0};
+
+// xorshift32, one stream per thread
+static unsigned thread_rand(void) {
+    unsigned x = thread_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    thread_rng = x;
+    return x;
+}
+
+static double thread_uniform(void) {
+    return thread_rand() / 4294967296.0;
+}
+
+// Wall-clock seconds (checkpoint timing)
+static double wall_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
 
 void signal_handler(int signum) {
     printf("\n\n[SIGNAL] Received interrupt. Saving model and shutting down...\n");
     keep_running = 0;
 }
 
-unsigned long hash_board(char board[BOARD_SIZE]) {
-    unsigned long hash = 5381;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        hash = ((hash << 5) + hash) + board[i];
-    }
-    return hash % Q_TABLE_SIZE;
-}
-
 void init_qtable(QTable *qt) {
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        qt->table[i] = NULL;
-    }
-    qt->total_entries = 0;
+    qt_init(qt);
 }
 
+// A symmetric table (-s) stores canonical boards only; qt_key() maps
+// the board and the action onto the shared row
 double get_q_value(QTable *qt, char board[BOARD_SIZE], int action) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = qt->table[hash];
-    
-    while (entry != NULL) {
-        if (entry->action == action && memcmp(entry->board, board, BOARD_SIZE) == 0) {
-            return entry->q_value;
-        }
-        entry = entry->next;
-    }
-    return 0.0;
+    QtKey k = qt_key(qt, qt_state(board));
+    return qt_get_shared(qt, k.state, qt_key_action(k, action));
 }
 
 void update_q_value(QTable *qt, char board[BOARD_SIZE], int action, double value) {
-    unsigned long hash = hash_board(board);
-    QEntry *entry = qt->table[hash];
-    
-    while (entry != NULL) {
-        if (entry->action == action && memcmp(entry->board, board, BOARD_SIZE) == 0) {
-            entry->q_value = value;
-            entry->visits++;
-            return;
-        }
-        entry = entry->next;
-    }
+    QtKey k = qt_key(qt, qt_state(board));
+    int a = qt_key_action(k, action);
+    
+    qt_update_shared(qt, k.state, a, (float)value);
+    // Release: whoever sees the dirty bit also sees the new value
+    __atomic_fetch_or(&dirty_moves[k.state], (uint16_t)(1u << a), __ATOMIC_RELEASE);
+}
+
+// Row of Q-values for board, in board orientation
+static void board_row(QTable *qt, Bitboard bb, float row[BOARD_SIZE]) {
+    QtKey k = qt_key(qt, bb_index(bb));
     
-    QEntry *new_entry = (QEntry *)malloc(sizeof(QEntry));
-    memcpy(new_entry->board, board, BOARD_SIZE);
-    new_entry->action = action;
-    new_entry->q_value = value;
-    new_entry->visits = 1;
-    new_entry->next = qt->table[hash];
-    qt->table[hash] = new_entry;
-    qt->total_entries++;
+    qt_snapshot_row(qt, k.state, row);
+    if (k.sym != 0) {
+        float canon[BOARD_SIZE];
+        memcpy(canon, row, sizeof(canon));
+        qt_key_row(k, canon, row);
+    }
 }
 
 char check_winner(char board[BOARD_SIZE]) {
@@ -144,17 +212,14 @@ int get_valid_moves(char board[BOARD_SIZE], int moves[BOARD_SIZE]) {
 }
 
 double get_max_q_value(QTable *qt, char board[BOARD_SIZE]) {
-    int valid_moves[BOARD_SIZE];
-    int num_moves = get_valid_moves(board, valid_moves);
+    Bitboard bb = bb_from_chars(board);
+    unsigned moves = bb_empty(bb);
+    float row[BOARD_SIZE];
     
-    if (num_moves == 0) return 0.0;
+    if (moves == 0) return 0.0;
     
-    double max_q = get_q_value(qt, board, valid_moves[0]);
-    for (int i = 1; i < num_moves; i++) {
-        double q = get_q_value(qt, board, valid_moves[i]);
-        if (q > max_q) max_q = q;
-    }
-    return max_q;
+    board_row(qt, bb, row);
+    return row[qt_row_best(row, moves)];
 }
 
 int choose_action(QTable *qt, char board[BOARD_SIZE], double epsilon) {
@@ -163,63 +228,40 @@ int choose_action(QTable *qt, char board[BOARD_SIZE], double epsilon) {
     
     if (num_moves == 0) return -1;
     
-    if ((double)rand() / RAND_MAX < epsilon) {
-        return valid_moves[rand() % num_moves];
-    }
-    
-    int best_move = valid_moves[0];
-    double best_q = get_q_value(qt, board, best_move);
-    
-    for (int i = 1; i < num_moves; i++) {
-        double q = get_q_value(qt, board, valid_moves[i]);
-        if (q > best_q) {
-            best_q = q;
-            best_move = valid_moves[i];
-        }
+    if (thread_uniform() < epsilon) {
+        return valid_moves[thread_rand() % num_moves];
     }
     
-    return best_move;
+    // Every move's value sits in one row of the table
+    Bitboard bb = bb_from_chars(board);
+    float row[BOARD_SIZE];
+    board_row(qt, bb, row);
+    return qt_row_best(row, bb_empty(bb));
 }
 
-// Minimax implementation
-int eval_board(char board[BOARD_SIZE]) {
-    char winner = check_winner(board);
-    if (winner == PLAYER_O) return 10;
-    if (winner == PLAYER_X) return -10;
-    return 0;
-}
+// Minimax implementation: the alpha-beta kernel and transposition table shared with the GUI.
+// Scored for O: +10 - depth for an O win, -10 + depth for an X win.
+// Each thread counts into thread_search; fold_search_stats() adds it to the total.
+static SearchStats minimax_stats = {0, 0};
 
 int minimax(char board[BOARD_SIZE], int depth, int is_max, int depth_limit) {
-    int score = eval_board(board);
-    if (score == 10) return score - depth;
-    if (score == -10) return score + depth;
-    char winner = check_winner(board);
-    if (winner != ' ') return 0;
-    if (depth_limit > 0 && depth >= depth_limit) return 0;
-    
-    if (is_max) {
-        int best = -1000;
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            if (board[i] == EMPTY) {
-                board[i] = PLAYER_O;
-                int val = minimax(board, depth + 1, 0, depth_limit);
-                board[i] = EMPTY;
-                if (val > best) best = val;
-            }
-        }
-        return best;
-    } else {
-        int best = 1000;
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            if (board[i] == EMPTY) {
-                board[i] = PLAYER_X;
-                int val = minimax(board, depth + 1, 1, depth_limit);
-                board[i] = EMPTY;
-                if (val < best) best = val;
-            }
-        }
-        return best;
-    }
+    Bitboard bb = bb_from_chars(board);
+    SearchContext ctx;
+    
+    search_init(&ctx, depth_limit, 1);
+    ctx.tt = thread_tt ? thread_tt : tt_shared();
+    int score = search_value(&ctx, bb.o, bb.x, is_max, depth);
+    
+    thread_search.nodes += ctx.stats.nodes;
+    thread_search.cutoffs += ctx.stats.cutoffs;
+    return score;
+}
+
+void fold_search_stats(void) {
+    __atomic_fetch_add(&minimax_stats.nodes, thread_search.nodes, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&minimax_stats.cutoffs, thread_search.cutoffs, __ATOMIC_RELAXED);
+    thread_search.nodes = 0;
+    thread_search.cutoffs = 0;
 }
 
 int minimax_move(char board[BOARD_SIZE], int depth_limit) {
@@ -270,15 +312,37 @@ int is_matrix_format(const char *filename) {
     return 0;
 }
 
+// Initialise every move O can make from board with its Minimax value;
+// returns the number of moves initialised
+static int init_moves_with_minimax(QTable *qt, char board[BOARD_SIZE]) {
+    int moves_initialized = 0;
+    
+    for (int pos = 0; pos < BOARD_SIZE; pos++) {
+        if (board[pos] == EMPTY) {
+            board[pos] = PLAYER_O;
+            int minimax_score = minimax(board, 0, 0, 4);
+            board[pos] = EMPTY;
+            
+            double init_q = (minimax_score / 15.0) + ((rand() / (double)RAND_MAX) * 0.05 - 0.025);
+            update_q_value(qt, board, pos, init_q);
+            moves_initialized++;
+        }
+    }
+    return moves_initialized;
+}
+
 void load_dataset_with_minimax_init(const char *filename, QTable *qt) {
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
+    int packed = ds_is_binary_file(filename);
+    int record_count = 0;
+    DsRecord *records = packed ? ds_read(filename, &record_count) : NULL;
+    FILE *fp = packed ? NULL : fopen(filename, "r");
+    if (packed ? !records : !fp) {
         printf("Warning: Could not load dataset from %s\n", filename);
         return;
     }
     
-    int is_matrix = is_matrix_format(filename);
-    const char *format_type = is_matrix ? "MATRIX" : "CHARACTER";
+    int is_matrix = !packed && is_matrix_format(filename);
+    const char *format_type = packed ? "PACKED BINARY" : is_matrix ? "MATRIX" : "CHARACTER";
     
     printf("Loading dataset: %s\n", filename);
     printf("Format detected: %s\n", format_type);
@@ -287,7 +351,19 @@ void load_dataset_with_minimax_init(const char *filename, QTable *qt) {
     char line[256];
     int boards_processed = 0, moves_initialized = 0;
     
-    while (fgets(line, sizeof(line), fp) != NULL) {
+    for (int r = 0; r < record_count; r++) {
+        char board[BOARD_SIZE];
+        ds_record_cells(&records[r], board);
+        boards_processed++;
+        moves_initialized += init_moves_with_minimax(qt, board);
+        
+        if (boards_processed % 500 == 0) {
+            printf("  Processed %d boards, initialized %d moves...\r", boards_processed, moves_initialized);
+            fflush(stdout);
+        }
+    }
+    
+    while (fp && fgets(line, sizeof(line), fp) != NULL) {
         line[strcspn(line, "\n")] = 0;
         
         // Skip comments and empty lines
@@ -333,18 +409,7 @@ void load_dataset_with_minimax_init(const char *filename, QTable *qt) {
         
         // Now process the board (same for both formats)
         boards_processed++;
-        
-        for (int pos = 0; pos < BOARD_SIZE; pos++) {
-            if (board[pos] == EMPTY) {
-                board[pos] = PLAYER_O;
-                int minimax_score = minimax(board, 0, 0, 4);
-                board[pos] = EMPTY;
-                
-                double init_q = (minimax_score / 15.0) + ((rand() / (double)RAND_MAX) * 0.05 - 0.025);
-                update_q_value(qt, board, pos, init_q);
-                moves_initialized++;
-            }
-        }
+        moves_initialized += init_moves_with_minimax(qt, board);
         
         if (boards_processed % 500 == 0 && boards_processed > 0) {
             printf("  Processed %d boards, initialized %d moves...\r", boards_processed, moves_initialized);
@@ -352,56 +417,130 @@ void load_dataset_with_minimax_init(const char *filename, QTable *qt) {
         }
     }
     
-    fclose(fp);
+    if (fp) fclose(fp);
+    free(records);
     printf("\n✓ Dataset initialization complete!\n");
     printf("  Boards: %d | Moves: %d | Q-entries: %d\n\n", 
            boards_processed, moves_initialized, qt->total_entries);
 }
 
-int load_qtable(const char *filename, QTable *qt) {
-    FILE *fp = fopen(filename, "r");
+// One "board...,action,q_value,visits" record; returns 0 for other lines
+static int parse_record(char *line, char board[BOARD_SIZE], int *action, double *q_value, int *visits) {
+    char *token = strtok(line, ",");
+    for (int i = 0; i < BOARD_SIZE && token != NULL; i++) {
+        board[i] = token[0];
+        token = strtok(NULL, ",");
+    }
+    
+    if (token == NULL) return 0;
+    *action = atoi(token);
+    token = strtok(NULL, ",");
+    if (token == NULL) return 0;
+    *q_value = atof(token);
+    token = strtok(NULL, ",\n");
+    *visits = (token != NULL) ? atoi(token) : 1;
+    
+    return *action >= 0 && *action < BOARD_SIZE;
+}
+
+// Apply the batches of <filename>.delta newer than checkpoint_sequence.
+// A batch counts only once its "# end" line is there, so a torn write at
+// the end of the log is ignored. Returns the records applied.
+static int replay_deltas(const char *filename, QTable *qt) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s%s", filename, DELTA_SUFFIX);
+    
+    FILE *fp = fopen(path, "r");
     if (!fp) return 0;
     
+    DeltaRecord *batch = malloc(sizeof(DeltaRecord) * BB_STATES * BOARD_SIZE);
+    if (!batch) {
+        fclose(fp);
+        return 0;
+    }
+    
     char line[256];
-    int loaded = 0;
+    int pending = 0, applied = 0;
     
     while (fgets(line, sizeof(line), fp)) {
+        unsigned sequence;
+        
+        if (sscanf(line, "# end %u", &sequence) == 1) {
+            if (sequence > checkpoint_sequence) {
+                for (int i = 0; i < pending; i++) {
+                    DeltaRecord *r = &batch[i];
+                    qt_set(qt, r->state, r->action, r->q, r->visits);
+                }
+                applied += pending;
+                checkpoint_sequence = sequence;
+            }
+            pending = 0;
+            continue;
+        }
         if (line[0] == '#' || line[0] == '\n') continue;
         
         char board[BOARD_SIZE];
         int action, visits;
         double q_value;
         
-        char *token = strtok(line, ",");
-        for (int i = 0; i < BOARD_SIZE && token != NULL; i++) {
-            board[i] = token[0];
-            token = strtok(NULL, ",");
-        }
+        if (!parse_record(line, board, &action, &q_value, &visits)) continue;
+        if (pending == BB_STATES * BOARD_SIZE) continue;
+        batch[pending].state = (int16_t)qt_state(board);
+        batch[pending].action = (int8_t)action;
+        batch[pending].q = (float)q_value;
+        batch[pending].visits = visits;
+        pending++;
+    }
+    
+    free(batch);
+    fclose(fp);
+    return applied;
+}
+
+// Load a text or .qtb model plus its delta log (if any); sets
+// checkpoint_sequence to the newest checkpoint found
+int load_qtable(const char *filename, QTable *qt) {
+    uint32_t sequence = 0;
+    int loaded = 0;
+    
+    checkpoint_sequence = 0;
+    if (qt_is_binary_file(filename)) {
+        if (!qt_read_binary(filename, qt, &sequence)) return 0;
+        loaded = qt->total_entries;
+    } else {
+        FILE *fp = fopen(filename, "r");
+        if (!fp) return 0;
         
-        if (token != NULL) {
-            action = atoi(token);
-            token = strtok(NULL, ",");
-            if (token != NULL) {
-                q_value = atof(token);
-                token = strtok(NULL, ",\n");
-                visits = (token != NULL) ? atoi(token) : 1;
-                
-                unsigned long hash = hash_board(board);
-                QEntry *new_entry = (QEntry *)malloc(sizeof(QEntry));
-                memcpy(new_entry->board, board, BOARD_SIZE);
-                new_entry->action = action;
-                new_entry->q_value = q_value;
-                new_entry->visits = visits;
-                new_entry->next = qt->table[hash];
-                qt->table[hash] = new_entry;
-                qt->total_entries++;
-                loaded++;
+        char line[256];
+        
+        // The header says whether the rows are canonical boards only
+        qt_set_symmetric(qt, 0);
+        while (fgets(line, sizeof(line), fp)) {
+            if (strncmp(line, QT_SYMMETRIC_TAG, strlen(QT_SYMMETRIC_TAG)) == 0) {
+                qt_set_symmetric(qt, 1);
+                continue;
             }
+            if (sscanf(line, "# Checkpoint: %u", &sequence) == 1) continue;
+            if (line[0] == '#' || line[0] == '\n') continue;
+            
+            char board[BOARD_SIZE];
+            int action, visits;
+            double q_value;
+            
+            if (!parse_record(line, board, &action, &q_value, &visits)) continue;
+            qt_set(qt, qt_state(board), action, (float)q_value, visits);
+            loaded++;
         }
+        
+        fclose(fp);
     }
     
-    fclose(fp);
-    return loaded;
+    checkpoint_sequence = sequence;
+    int replayed = replay_deltas(filename, qt);
+    if (replayed > 0) {
+        printf("Replayed %d delta records (checkpoint %u)\n", replayed, checkpoint_sequence);
+    }
+    return replayed > 0 ? qt->total_entries : loaded;
 }
 
 char play_episode(QTable *qt_o, double epsilon_o, 
@@ -452,68 +591,303 @@ void update_episode(QTable *qt, char history[][BOARD_SIZE], int actions[], int h
     }
 }
 
-void save_qtable(const char *filename, QTable *qt, TrainingMode mode) {
+// Move tmp over path in one step, so readers see the old file or the new one
+static int replace_file(const char *tmp, const char *path) {
+#ifdef _WIN32
+    return MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(tmp, path) == 0;
+#endif
+}
+
+static int write_qtable_text(const char *filename, QTable *qt, TrainingMode mode, unsigned sequence) {
     FILE *fp = fopen(filename, "w");
-    if (!fp) {
-        printf("[ERROR] Could not save model to %s\n", filename);
-        return;
-    }
+    if (!fp) return 0;
     
     const char *mode_str = (mode == MODE_FROM_SCRATCH) ? "From-Scratch" : 
-                          (mode == MODE_DATASET_INIT) ? "Dataset-Init" : "Resumed";
+                          (mode == MODE_DATASET_INIT) ? "Dataset-Init" :
+                          (mode == MODE_SOLVE) ? "Value-Iteration" : "Resumed";
     
     fprintf(fp, "# Q-Learning Model - %s Training\n", mode_str);
     fprintf(fp, "# Format: board_state,action,q_value,visits\n");
+    if (qt->symmetric) {
+        fprintf(fp, "%s\n", QT_SYMMETRIC_TAG);
+    }
+    if (sequence > 0) {
+        fprintf(fp, "# Checkpoint: %u\n", sequence);
+    }
     fprintf(fp, "# Total entries: %d\n\n", qt->total_entries);
     
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        QEntry *entry = qt->table[i];
-        while (entry != NULL) {
+    for (int state = 0; state < BB_STATES; state++) {
+        if (!qt->present[state]) continue;
+        
+        char board[BOARD_SIZE];
+        qt_board(state, board);
+        for (int action = 0; action < BOARD_SIZE; action++) {
+            if (!qt_has(qt, state, action)) continue;
             for (int j = 0; j < BOARD_SIZE; j++) {
-                fprintf(fp, "%c,", entry->board[j]);
+                fprintf(fp, "%c,", board[j]);
             }
-            fprintf(fp, "%d,%.6f,%d\n", entry->action, entry->q_value, entry->visits);
-            entry = entry->next;
+            fprintf(fp, "%d,%.6f,%d\n", action, qt->q[state][action], qt->visits[state][action]);
         }
     }
     
-    fclose(fp);
+    int ok = !ferror(fp);
+    if (fclose(fp) != 0) ok = 0;
+    return ok;
 }
 
-void free_qtable(QTable *qt) {
-    for (int i = 0; i < Q_TABLE_SIZE; i++) {
-        QEntry *entry = qt->table[i];
-        while (entry != NULL) {
-            QEntry *temp = entry;
-            entry = entry->next;
-            free(temp);
-        }
-        qt->table[i] = NULL;
+// A name ending in .qtb gets the binary format (qtable_file.h), anything else text.
+// The model is written to <filename>.tmp and renamed over filename, so a crash
+// mid-write leaves the previous model intact. sequence numbers the checkpoint
+// the model holds (0 = none). Returns 1 on success.
+int save_qtable(const char *filename, QTable *qt, TrainingMode mode, unsigned sequence) {
+    char tmp[1024];
+    int ok;
+    
+    snprintf(tmp, sizeof(tmp), "%s.tmp", filename);
+    ok = qt_is_binary_name(filename) ? qt_save_binary(tmp, qt, sequence) : write_qtable_text(tmp, qt, mode, sequence);
+    if (ok) ok = replace_file(tmp, filename);
+    if (!ok) {
+        printf("[ERROR] Could not save model to %s\n", filename);
+        remove(tmp);
     }
-    qt->total_entries = 0;
+    return ok;
+}
+
+void free_qtable(QTable *qt) {
+    // Stored inline; just empty it
+    qt_init(qt);
 }
 
-void print_stats(TrainingStats *stats) {
+// Print and reset the per-interval counters (called by whichever worker
+// finishes the interval's last episode)
+void print_stats(TrainingStats *stats, int episodes, double epsilon) {
     time_t current_time = time(NULL);
     double elapsed = difftime(current_time, stats->start_time);
+    int o_wins = __atomic_exchange_n(&stats->o_wins, 0, __ATOMIC_RELAXED);
+    int x_wins = __atomic_exchange_n(&stats->x_wins, 0, __ATOMIC_RELAXED);
+    int draws = __atomic_exchange_n(&stats->draws, 0, __ATOMIC_RELAXED);
+    int games = o_wins + x_wins + draws;
     
-    printf("\n=== Episode %d ===\n", stats->total_episodes);
+    if (games == 0) games = 1;
+    printf("\n=== Episode %d ===\n", episodes);
     printf("Last %d games: O:%d (%.1f%%) X:%d (%.1f%%) Draw:%d (%.1f%%)\n",
-           STATS_INTERVAL,
-           stats->o_wins, stats->o_wins * 100.0 / STATS_INTERVAL,
-           stats->x_wins, stats->x_wins * 100.0 / STATS_INTERVAL,
-           stats->draws, stats->draws * 100.0 / STATS_INTERVAL);
+           games,
+           o_wins, o_wins * 100.0 / games,
+           x_wins, x_wins * 100.0 / games,
+           draws, draws * 100.0 / games);
     printf("Epsilon: %.4f | Q-entries: %d | Time: %.0fs\n",
-           stats->current_epsilon, global_qtable_o.total_entries, elapsed);
+           epsilon, __atomic_load_n(&global_qtable_o.total_entries, __ATOMIC_RELAXED), elapsed);
+    
+    pthread_mutex_lock(&checkpoint_lock);
+    CheckpointStats cp = checkpoint_stats;
+    pthread_mutex_unlock(&checkpoint_lock);
+    if (cp.saved > 0) {
+        printf("Checkpoints: %d saved (%d full), last %d records in %.1f ms (copy %.1f ms), avg %.1f ms\n",
+               cp.saved, cp.full, cp.last_records, cp.last_ms, cp.last_copy_ms, cp.total_ms / cp.saved);
+        printf("Delta log: %d records | %d merged, %d failed\n", cp.log_records, cp.merged, cp.failed);
+    }
+}
+
+// Epsilon after `episodes` episodes: decays by EPSILON_DECAY per episode
+// down to EPSILON_MIN, counted across all workers
+static double epsilon_after(double epsilon_start, int episodes) {
+    double epsilon = epsilon_start * pow(EPSILON_DECAY, episodes);
+    return epsilon > EPSILON_MIN ? epsilon : EPSILON_MIN;
+}
+
+// Full checkpoint: the whole table becomes the new model, then the delta
+// log it supersedes is dropped (a stale log left by a crash in between is
+// skipped on load: its batches are not newer than the model)
+static int save_full_checkpoint(const char *output_file, QTable *qt, unsigned sequence) {
+    char path[1024];
+    
+    if (!save_qtable(output_file, qt, global_stats.mode, sequence)) return 0;
+    snprintf(path, sizeof(path), "%s%s", output_file, DELTA_SUFFIX);
+    remove(path);
+    return 1;
+}
+
+// Take the dirty marks. Done before reading values: an update after this
+// point marks its pair again and goes into the next checkpoint.
+static uint16_t take_dirty(int state) {
+    return __atomic_exchange_n(&dirty_moves[state], 0, __ATOMIC_ACQUIRE);
+}
+
+// Copy the pairs changed since the last checkpoint into delta_buffer
+static int collect_deltas(void) {
+    int count = 0;
+    
+    for (int state = 0; state < BB_STATES; state++) {
+        for (unsigned bits = take_dirty(state); bits; bits &= bits - 1) {
+            int action = bb_first(bits);
+            DeltaRecord *r = &delta_buffer[count++];
+            r->state = (int16_t)state;
+            r->action = (int8_t)action;
+            r->q = qt_get_shared(&global_qtable_o, state, action);
+            r->visits = __atomic_load_n(&global_qtable_o.visits[state][action], __ATOMIC_RELAXED);
+        }
+    }
+    return count;
+}
+
+// Append one batch (model-format records, then "# end <sequence>")
+static int append_deltas(const char *output_file, int count, unsigned sequence) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s%s", output_file, DELTA_SUFFIX);
+    
+    FILE *fp = fopen(path, "a");
+    if (!fp) return 0;
+    
+    for (int i = 0; i < count; i++) {
+        const DeltaRecord *r = &delta_buffer[i];
+        char board[BOARD_SIZE];
+        qt_board(r->state, board);
+        for (int j = 0; j < BOARD_SIZE; j++) {
+            fprintf(fp, "%c,", board[j]);
+        }
+        fprintf(fp, "%d,%.9g,%d\n", r->action, r->q, r->visits);   // %.9g: the float comes back exact
+    }
+    fprintf(fp, "# end %u\n", sequence);
+    
+    int ok = !ferror(fp);
+    if (fclose(fp) != 0) ok = 0;
+    return ok;
+}
+
+// Ask the writer thread for a checkpoint; returns at once
+static void request_checkpoint(void) {
+    pthread_mutex_lock(&checkpoint_lock);
+    if (checkpoint_pending) {
+        checkpoint_stats.merged++;
+    }
+    checkpoint_pending = 1;
+    pthread_cond_signal(&checkpoint_cond);
+    pthread_mutex_unlock(&checkpoint_lock);
+}
+
+// Writer thread: one checkpoint per request until stop_checkpoint_writer().
+// The first checkpoint of a run is full, as is one after a failure (its
+// dirty marks are gone) or once the log holds COMPACT_EVERY batches or as
+// many records as the table; the rest append deltas. The final model is
+// saved by the caller.
+static void *checkpoint_writer(void *arg) {
+    const char *output_file = (const char *)arg;
+    int force_full = 1;
+    int since_full = 0;
+    
+    pthread_mutex_lock(&checkpoint_lock);
+    while (1) {
+        while (!checkpoint_pending && !checkpoint_quit) {
+            pthread_cond_wait(&checkpoint_cond, &checkpoint_lock);
+        }
+        if (checkpoint_quit) break;
+        checkpoint_pending = 0;
+        pthread_mutex_unlock(&checkpoint_lock);
+        
+        int full = force_full || since_full >= COMPACT_EVERY ||
+                   checkpoint_stats.log_records >= __atomic_load_n(&global_qtable_o.total_entries, __ATOMIC_RELAXED);
+        unsigned sequence = checkpoint_sequence + 1;
+        int records, ok;
+        double start = wall_seconds(), copied;
+        
+        if (full) {
+            for (int state = 0; state < BB_STATES; state++) take_dirty(state);
+            qt_snapshot(&checkpoint_table, &global_qtable_o);
+            copied = wall_seconds();
+            records = checkpoint_table.total_entries;
+            ok = save_full_checkpoint(output_file, &checkpoint_table, sequence);
+        } else {
+            records = collect_deltas();
+            copied = wall_seconds();
+            ok = append_deltas(output_file, records, sequence);
+        }
+        double done = wall_seconds();
+        
+        force_full = !ok;
+        since_full = full ? 0 : since_full + 1;
+        pthread_mutex_lock(&checkpoint_lock);
+        if (ok) {
+            checkpoint_sequence = sequence;
+            checkpoint_stats.saved++;
+            checkpoint_stats.full += full;
+            checkpoint_stats.last_records = records;
+            checkpoint_stats.log_records = full ? 0 : checkpoint_stats.log_records + records;
+            checkpoint_stats.last_ms = (done - start) * 1000.0;
+            checkpoint_stats.last_copy_ms = (copied - start) * 1000.0;
+            checkpoint_stats.total_ms += checkpoint_stats.last_ms;
+        } else {
+            checkpoint_stats.failed++;
+        }
+    }
+    pthread_mutex_unlock(&checkpoint_lock);
+    return NULL;
+}
+
+static void stop_checkpoint_writer(pthread_t writer) {
+    pthread_mutex_lock(&checkpoint_lock);
+    checkpoint_quit = 1;
+    pthread_cond_signal(&checkpoint_cond);
+    pthread_mutex_unlock(&checkpoint_lock);
+    pthread_join(writer, NULL);
+}
+
+void *train_worker(void *arg) {
+    Worker *w = (Worker *)arg;
+    double epsilon = w->epsilon_start;
+    
+    thread_rng = ((unsigned)time(NULL) ^ (0x9E3779B9u * (unsigned)(w->id + 1))) | 1u;
+    thread_tt = w->tt;
+    
+    while (keep_running) {
+        int claimed = __atomic_fetch_add(&episodes_claimed, 1, __ATOMIC_RELAXED);
+        if (w->max_episodes > 0 && claimed >= w->max_episodes) break;
+        
+        char history[50][BOARD_SIZE];
+        int actions[50];
+        int history_len;
+        
+        char winner = play_episode(&global_qtable_o, epsilon, history, actions, &history_len);
+        
+        double reward;
+        if (winner == PLAYER_O) {
+            reward = REWARD_WIN;
+            __atomic_fetch_add(&global_stats.o_wins, 1, __ATOMIC_RELAXED);
+        } else if (winner == PLAYER_X) {
+            reward = REWARD_LOSE;
+            __atomic_fetch_add(&global_stats.x_wins, 1, __ATOMIC_RELAXED);
+        } else {
+            reward = REWARD_DRAW;
+            __atomic_fetch_add(&global_stats.draws, 1, __ATOMIC_RELAXED);
+        }
+        
+        update_episode(&global_qtable_o, history, actions, history_len, reward);
+        
+        int done = __atomic_add_fetch(&global_stats.total_episodes, 1, __ATOMIC_RELAXED);
+        epsilon = epsilon_after(w->epsilon_start, done);
+        
+        if (done % STATS_INTERVAL == 0) {
+            print_stats(&global_stats, done, epsilon);
+        }
+        
+        if (done % CHECKPOINT_INTERVAL == 0) {
+            request_checkpoint();
+        }
+    }
+    
+    fold_search_stats();
+    return NULL;
 }
 
 void train_continuous(TrainingMode mode, const char *dataset_file, const char *checkpoint_file, 
-                     const char *output_file, int max_episodes) {
+                     const char *output_file, int max_episodes, int num_threads) {
     printf("\n========================================\n");
     printf("UNIFIED Q-LEARNING TRAINING SYSTEM\n");
     printf("========================================\n\n");
     
     init_qtable(&global_qtable_o);
+    qt_set_symmetric(&global_qtable_o, use_symmetry);
     double epsilon_start;
     
     // Determine initialization strategy
@@ -526,6 +900,8 @@ void train_continuous(TrainingMode mode, const char *dataset_file, const char *c
             global_stats.mode = MODE_RESUME;
         } else {
             printf("✗ Checkpoint not found. Switching to dataset-init mode.\n\n");
+            init_qtable(&global_qtable_o);
+            qt_set_symmetric(&global_qtable_o, use_symmetry);
             mode = MODE_DATASET_INIT;
         }
     }
@@ -555,77 +931,288 @@ void train_continuous(TrainingMode mode, const char *dataset_file, const char *c
     printf("  Discount (γ): %.2f\n", GAMMA);
     printf("  Epsilon: %.2f → %.2f\n", epsilon_start, EPSILON_MIN);
     printf("  Checkpoint: every %d episodes\n", CHECKPOINT_INTERVAL);
+    printf("  Threads: %d\n", num_threads);
+    printf("  Symmetry-reduced: %s\n", global_qtable_o.symmetric ? "yes" : "no");
     printf("  Output: %s\n\n", output_file);
     
     printf("Press Ctrl+C to stop and save.\nTraining...\n");
     
-    while (keep_running && (max_episodes <= 0 || global_stats.total_episodes < max_episodes)) {
-        char history[50][BOARD_SIZE];
-        int actions[50];
-        int history_len;
-        
-        char winner = play_episode(&global_qtable_o, global_stats.current_epsilon,
-                                   history, actions, &history_len);
-        
-        double reward;
-        if (winner == PLAYER_O) {
-            reward = REWARD_WIN;
-            global_stats.o_wins++;
-        } else if (winner == PLAYER_X) {
-            reward = REWARD_LOSE;
-            global_stats.x_wins++;
-        } else {
-            reward = REWARD_DRAW;
-            global_stats.draws++;
-        }
-        
-        update_episode(&global_qtable_o, history, actions, history_len, reward);
-        
-        global_stats.total_episodes++;
-        
-        if (global_stats.current_epsilon > EPSILON_MIN) {
-            global_stats.current_epsilon *= EPSILON_DECAY;
-        }
-        
-        if (global_stats.total_episodes % STATS_INTERVAL == 0) {
-            print_stats(&global_stats);
-            global_stats.x_wins = 0;
-            global_stats.o_wins = 0;
-            global_stats.draws = 0;
+    pthread_t writer;
+    int have_writer = pthread_create(&writer, NULL, checkpoint_writer, (void *)output_file) == 0;
+    if (!have_writer) {
+        printf("[WARNING] Could not start checkpoint writer; saving at the end only\n");
+    }
+    
+    // Worker tables are made here: tt_create() sets up shared hash keys once
+    Worker workers[MAX_THREADS];
+    int started = 0;
+    
+    for (int i = 0; i < num_threads; i++) {
+        workers[i].id = i;
+        workers[i].tt = tt_create(TT_DEFAULT_BITS);
+        workers[i].epsilon_start = epsilon_start;
+        workers[i].max_episodes = max_episodes;
+        if (!workers[i].tt) {
+            printf("[ERROR] Out of memory for worker %d\n", i);
+            break;
         }
-        
-        if (global_stats.total_episodes % CHECKPOINT_INTERVAL == 0) {
-            printf("\n[CHECKPOINT] Saving...\n");
-            save_qtable(output_file, &global_qtable_o, global_stats.mode);
-            printf("[CHECKPOINT] Saved.\n\n");
+        if (pthread_create(&workers[i].thread, NULL, train_worker, &workers[i]) != 0) {
+            printf("[ERROR] Could not start worker %d\n", i);
+            tt_free(workers[i].tt);
+            break;
         }
+        started++;
     }
     
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+        tt_free(workers[i].tt);
+    }
+    if (have_writer) stop_checkpoint_writer(writer);
+    fold_search_stats();
+    
+    double elapsed = difftime(time(NULL), global_stats.start_time);
+    
     printf("\n\n========================================\n");
     printf("TRAINING COMPLETE\n");
     printf("========================================\n");
     printf("Episodes: %d | Entries: %d\n", global_stats.total_episodes, global_qtable_o.total_entries);
+    if (elapsed > 0) {
+        printf("Throughput: %.0f episodes/sec on %d threads\n", global_stats.total_episodes / elapsed, started);
+    }
+    printf("Minimax search: %lu nodes, %lu cutoffs\n", minimax_stats.nodes, minimax_stats.cutoffs);
+    if (checkpoint_stats.saved > 0) {
+        printf("Checkpoints: %d in background (%d full), %.1f ms total (%.1f ms avg)\n",
+               checkpoint_stats.saved, checkpoint_stats.full,
+               checkpoint_stats.total_ms, checkpoint_stats.total_ms / checkpoint_stats.saved);
+    }
     printf("Saving final model...\n");
-    save_qtable(output_file, &global_qtable_o, global_stats.mode);
-    printf("✓ Saved to: %s\n", output_file);
+    if (save_full_checkpoint(output_file, &global_qtable_o, checkpoint_sequence + 1)) {
+        printf("✓ Saved to: %s\n", output_file);
+    }
     
     free_qtable(&global_qtable_o);
 }
 
+// Solve mode: exact Q* by value iteration instead of sampled episodes.
+// Every legal board with O to move and no line yet is a state. O's move
+// ends the game or X answers from the opponent model: the policy's move
+// with probability 1 - random_share, a uniform empty cell otherwise. One
+// sweep computes, from the previous sweep's values,
+//   Q(s,a) = sum over X replies of P(reply) * (reward + GAMMA * max Q(s',.))
+// with the rewards above given only when the game ends. Sweeps are
+// synchronous, so each thread takes a slice of the states without locks.
+#define SOLVE_EPSILON 1e-7
+#define SOLVE_MAX_SWEEPS 100
+
+static int solve_states[BB_STATES];
+static int solve_count = 0;
+static float solve_q[2][BB_STATES][BOARD_SIZE];
+static int8_t solve_reply[BB_STATES];      // policy's X move on each X-to-move board
+static double solve_random_share = 0.0;
+
+typedef struct {
+    pthread_t thread;
+    int running;             // 0: ran on the calling thread
+    int first, last;         // slice of solve_states
+    int from;                // solve_q[from] -> solve_q[1 - from]
+    double max_delta;
+} SolveSlice;
+
+// Value of O-to-move board bb under the given table: max over O's moves
+static double solve_state_value(float (*q)[BOARD_SIZE], Bitboard bb) {
+    unsigned moves = bb_empty(bb);
+    return q[bb_index(bb)][qt_row_best(q[bb_index(bb)], moves)];
+}
+
+static double solve_backup(float (*q)[BOARD_SIZE], Bitboard bb, int action) {
+    Bitboard after = {bb.x, (uint16_t)(bb.o | (1u << action))};
+    
+    if (bb_has_win(after.o)) return REWARD_WIN;
+    if (bb_is_full(after)) return REWARD_DRAW;
+    
+    unsigned empty = bb_empty(after);
+    int reply = solve_reply[bb_index(after)];
+    double uniform = solve_random_share / bb_popcount(empty);
+    double total = 0.0;
+    
+    for (unsigned m = empty; m; m &= m - 1) {
+        int cell = bb_first(m);
+        double p = uniform + (cell == reply ? 1.0 - solve_random_share : 0.0);
+        if (p == 0.0) continue;
+        
+        Bitboard next = {(uint16_t)(after.x | (1u << cell)), after.o};
+        double value;
+        if (bb_has_win(next.x)) value = REWARD_LOSE;
+        else if (bb_is_full(next)) value = REWARD_DRAW;
+        else value = GAMMA * solve_state_value(q, next);
+        total += p * value;
+    }
+    return total;
+}
+
+static void *solve_sweep(void *arg) {
+    SolveSlice *slice = (SolveSlice *)arg;
+    float (*src)[BOARD_SIZE] = solve_q[slice->from];
+    float (*dst)[BOARD_SIZE] = solve_q[1 - slice->from];
+    
+    slice->max_delta = 0.0;
+    for (int i = slice->first; i < slice->last; i++) {
+        int state = solve_states[i];
+        Bitboard bb = bb_from_index(state);
+        
+        for (unsigned m = bb_empty(bb); m; m &= m - 1) {
+            int action = bb_first(m);
+            dst[state][action] = (float)solve_backup(src, bb, action);
+            double delta = fabs(dst[state][action] - src[state][action]);
+            if (delta > slice->max_delta) slice->max_delta = delta;
+        }
+    }
+    return NULL;
+}
+
+// opponent: an opponent.h policy name; random_share: chance X plays a
+// uniform random cell instead of the policy's move
+int solve_qtable(const char *output_file, const char *opponent, double random_share, int num_threads) {
+    int kind = opp_parse(opponent);
+    if (kind < 0) {
+        printf("[ERROR] Unknown opponent: %s (random, depth2, depth4, perfect)\n", opponent);
+        return 0;
+    }
+    if (kind == OPP_RANDOM) random_share = 1.0;
+    if (random_share < 0.0) random_share = 0.0;
+    if (random_share > 1.0) random_share = 1.0;
+    solve_random_share = random_share;
+    
+    printf("\n========================================\n");
+    printf("VALUE ITERATION (EXACT Q*)\n");
+    printf("========================================\n\n");
+    printf("Opponent (X): %s, %.0f%% random moves\n", opponent, random_share * 100.0);
+    
+    double start = wall_seconds();
+    
+    // States, and X's policy reply to every O move (searched here, on one thread)
+    static OpponentPolicy policy;
+    opp_init(&policy, (OpponentKind)kind);
+    solve_count = 0;
+    for (int state = 0; state < BB_STATES; state++) {
+        Bitboard bb = bb_from_index(state);
+        if (bb_popcount(bb.x) != bb_popcount(bb.o) + 1) continue;
+        if (bb_has_win(bb.x) || bb_has_win(bb.o) || bb_is_full(bb)) continue;
+        solve_states[solve_count++] = state;
+        
+        for (unsigned m = bb_empty(bb); m; m &= m - 1) {
+            Bitboard after = {bb.x, (uint16_t)(bb.o | (1u << bb_first(m)))};
+            int index = bb_index(after);
+            if (bb_has_win(after.o) || bb_is_full(after)) continue;
+            solve_reply[index] = (int8_t)(random_share < 1.0 ? opp_move(&policy, after, 0) : -1);
+        }
+    }
+    memset(solve_q, 0, sizeof(solve_q));
+    printf("States: %d O-to-move boards | Threads: %d\n\n", solve_count, num_threads);
+    
+    SolveSlice slices[MAX_THREADS];
+    int from = 0, sweeps = 0;
+    double max_delta = 0.0;
+    
+    do {
+        max_delta = 0.0;
+        for (int t = 0; t < num_threads; t++) {
+            slices[t].first = solve_count * t / num_threads;
+            slices[t].last = solve_count * (t + 1) / num_threads;
+            slices[t].from = from;
+            slices[t].running = num_threads > 1 &&
+                pthread_create(&slices[t].thread, NULL, solve_sweep, &slices[t]) == 0;
+            if (!slices[t].running) solve_sweep(&slices[t]);
+        }
+        for (int t = 0; t < num_threads; t++) {
+            if (slices[t].running) pthread_join(slices[t].thread, NULL);
+            if (slices[t].max_delta > max_delta) max_delta = slices[t].max_delta;
+        }
+        from = 1 - from;
+        sweeps++;
+        printf("Sweep %3d: max |dQ| = %.3e\n", sweeps, max_delta);
+    } while (max_delta > SOLVE_EPSILON && sweeps < SOLVE_MAX_SWEEPS);
+    
+    double seconds = wall_seconds() - start;
+    
+    // solve_q[from] is the last sweep; a symmetric table keeps canonical boards
+    init_qtable(&global_qtable_o);
+    qt_set_symmetric(&global_qtable_o, use_symmetry);
+    for (int i = 0; i < solve_count; i++) {
+        int state = solve_states[i];
+        QtKey k = qt_key(&global_qtable_o, state);
+        if (k.state != state || k.sym != 0) continue;
+        for (unsigned m = bb_empty(bb_from_index(state)); m; m &= m - 1) {
+            int action = bb_first(m);
+            qt_set(&global_qtable_o, state, action, solve_q[from][state][action], 0);
+        }
+    }
+    
+    printf("\n✓ Converged in %d sweeps (%.3f s), %d Q-entries\n", sweeps, seconds, global_qtable_o.total_entries);
+    if (policy.solved > 0) {
+        printf("  Opponent search: %d boards, %lu nodes\n", policy.solved, policy.stats.nodes);
+    }
+    
+    global_stats.mode = MODE_SOLVE;
+    if (!save_full_checkpoint(output_file, &global_qtable_o, 0)) return 0;
+    printf("✓ Saved to: %s\n", output_file);
+    return 1;
+}
+
+int cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
 int main(int argc, char *argv[]) {
     srand(time(NULL));
     signal(SIGINT, signal_handler);
     
+    int num_threads = cpu_count();
+    const char *prog = argv[0];
+    
+    // Leading options: "-t N" training threads (default: all cores),
+    // "-s" / "--symmetric" symmetry-reduced table (a resumed model keeps
+    // its own setting)
+    while (argc > 1 && argv[1][0] == '-') {
+        if (argc > 2 && strcmp(argv[1], "-t") == 0) {
+            num_threads = atoi(argv[2]);
+            argv += 2;
+            argc -= 2;
+        } else if (strcmp(argv[1], "-s") == 0 || strcmp(argv[1], "--symmetric") == 0) {
+            use_symmetry = 1;
+            argv++;
+            argc--;
+        } else {
+            break;
+        }
+    }
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > MAX_THREADS) num_threads = MAX_THREADS;
+    
     if (argc < 2) {
-        printf("Usage: %s <mode> [options]\n", argv[0]);
+        printf("Usage: %s [-t threads] [-s] <mode> [options]\n", prog);
         printf("Modes:\n");
         printf("  scratch <output_file> [episodes]     - Train from zero\n");
         printf("  dataset <dataset> <output> [episodes] - Init from dataset\n");
         printf("  resume <checkpoint> <output> [episodes] - Resume training\n");
+        printf("  convert <input> <output>               - Rewrite a model as text or .qtb\n");
+        printf("  solve <output> [opponent] [random_share] - Exact Q* by value iteration\n");
         printf("\nNotes:\n");
         printf("  - Dataset can be CHARACTER or MATRIX format (auto-detected)\n");
         printf("  - Matrix format: 1.0,-1.0,0.0,...,+1\n");
         printf("  - Character format: x,o,b,...,win\n");
+        printf("  - Output names ending in .qtb are saved in the binary format\n");
+        printf("  - -s (--symmetric) stores canonical boards only (symmetries share values)\n");
+        printf("  - solve opponents: random, depth2, depth4 (default), perfect;\n");
+        printf("    random_share (0-1) mixes in uniform random X moves\n");
         return 1;
     }
     
@@ -649,12 +1236,31 @@ int main(int argc, char *argv[]) {
         checkpoint_file = (argc > 2) ? argv[2] : "../../models/q learning/q_learning_o_dataset_continuous.txt";
         output_file = checkpoint_file;
         if (argc > 3) max_episodes = atoi(argv[3]);
+    } else if (strcmp(argv[1], "convert") == 0) {
+        if (argc < 4) {
+            printf("Usage: %s convert <input> <output>\n", prog);
+            return 1;
+        }
+        init_qtable(&global_qtable_o);
+        int loaded = load_qtable(argv[2], &global_qtable_o);
+        if (loaded <= 0) {
+            printf("[ERROR] No entries loaded from %s\n", argv[2]);
+            return 1;
+        }
+        if (!save_qtable(argv[3], &global_qtable_o, MODE_RESUME, checkpoint_sequence)) return 1;
+        printf("✓ Converted %s -> %s (%d entries)\n", argv[2], argv[3], global_qtable_o.total_entries);
+        return 0;
+    } else if (strcmp(argv[1], "solve") == 0) {
+        output_file = (argc > 2) ? argv[2] : "../../models/q learning/q_learning_solved.txt";
+        const char *opponent = (argc > 3) ? argv[3] : "depth4";
+        double random_share = (argc > 4) ? atof(argv[4]) : 0.0;
+        return solve_qtable(output_file, opponent, random_share, num_threads) ? 0 : 1;
     } else {
         printf("Unknown mode: %s\n", argv[1]);
         return 1;
     }
     
-    train_continuous(mode, dataset_file, checkpoint_file, output_file, max_episodes);
+    train_continuous(mode, dataset_file, checkpoint_file, output_file, max_episodes, num_threads);
     
     return 0;
 }